@@ -0,0 +1,784 @@
+#include <iostream>
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <deque>
+#include <chrono>
+#include <limits>
+#include <sstream>
+#include <fstream>
+#include <thread>
+#include <random>
+#include <iomanip>
+#include <numeric>
+#include <string>
+using namespace std;
+
+#include "Arena.hpp"
+#include "PriorityQueue.hpp"
+#include "HashTable.hpp"
+#include "GeneralSearch.hpp"
+#include "StaticSearch.hpp"
+
+#include "NPuzzleSetting.hpp"
+#include "NPuzzleDefinition.hpp"
+#include "NPuzzleUtility.hpp"
+#include "NPuzzleGoal.hpp"
+#include "NPuzzleProblem.hpp"
+#include "NPuzzleHeuristicFunction.hpp"
+#include "NPuzzleHeuristicKernel.hpp"
+#include "NPuzzleOperatorSelection.hpp"
+#include "NPuzzleCheckpoint.hpp"
+#include "NPuzzleHeuristicTable.hpp"
+#include "NPuzzlePerimeter.hpp"
+#include "NPuzzleSolver.hpp"
+#include "NPuzzleAnytimeSolver.hpp"
+#include "NPuzzleFringeSolver.hpp"
+#include "NPuzzleRealTimeSolver.hpp"
+#include "NPuzzleBoard.hpp"
+#include "NPuzzleMacroSolver.hpp"
+#include "NPuzzleLazyHeuristic.hpp"
+#include "NPuzzleLazySolver.hpp"
+#include "NPuzzleFrontierSolver.hpp"
+#include "NPuzzleBatchFile.hpp"
+#include "NPuzzleGenerator.hpp"
+#include "NPuzzleStaticSolver.hpp"
+using namespace NPuzzle;
+
+// Run a function repeatedly and return the average nanoseconds per item.
+template <class FuncT>
+double measure(FuncT func, size_t items, int repetitions = 20)
+{
+    func(); // Warm up.
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; i++)
+        func();
+    auto elapsed = chrono::steady_clock::now() - start;
+    return chrono::duration<double, nano>(elapsed).count() / repetitions / items;
+}
+
+// Generate random states (in canonical labels), solvability does not matter here.
+vector<NPuzzleState> randomStates(size_t count, unsigned seed)
+{
+    mt19937 rng(seed);
+    vector<NPuzzleState> states(count, NPuzzleGoal::DefaultGoal());
+    for (auto& state : states)
+        shuffle(state.begin(), state.end(), rng);
+    return states;
+}
+
+void benchmarkHeuristicKernels()
+{
+    using namespace HeuristicKernel;
+
+    const size_t count = 1 << 16;
+    auto states = randomStates(count, 42);
+
+    vector<NPuzzleNode> nodes;
+    vector<NPuzzlePackedState> packed;
+    for (auto& state : states)
+    {
+        nodes.push_back(NPuzzleNode(state, 0));
+        packed.push_back(packState(state));
+    }
+    vector<int> out(count);
+    volatile int sink = 0;
+
+    cout << "Heuristic kernels on " << count << " random states (ns/state):" << endl;
+    cout << "  CPU dispatch: " << GetInstructionSetName(GetDispatch().set) << endl;
+
+    auto reference = [&](NPuzzleCostFunction hFunc, const char* name) {
+        double ns = measure([&] {
+            int sum = 0;
+            for (auto& node : nodes)
+                sum += hFunc(node);
+            sink = sum;
+        }, count);
+        cout << "  " << setw(36) << left << name << fixed << setprecision(2) << ns << endl;
+    };
+    reference(GetMisplacedTileCount, "GetMisplacedTileCount");
+    reference(GetManhattanDistance, "GetManhattanDistance");
+
+    if (!packable)
+    {
+        cout << "  Board too large to be packed, skipping kernels." << endl << endl;
+        return;
+    }
+
+    vector<InstructionSet> sets{ InstructionSet::Scalar };
+#ifdef NPUZZLE_KERNEL_X86
+    if (__builtin_cpu_supports("ssse3")) sets.push_back(InstructionSet::SSE);
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) sets.push_back(InstructionSet::AVX2);
+#endif
+
+    auto kernel = [&](BatchKernelT batch, NPuzzleCostFunction hFunc, string name) {
+        batch(packed.data(), out.data(), count);
+        for (size_t i = 0; i < count; i++)
+        {
+            if (out[i] != hFunc(nodes[i]))
+            {
+                cout << "  " << name << " MISMATCH at state " << i << endl;
+                return;
+            }
+        }
+        double ns = measure([&] { batch(packed.data(), out.data(), count); }, count);
+        cout << "  " << setw(36) << left << name << fixed << setprecision(2) << ns << endl;
+    };
+    for (auto set : sets)
+    {
+        string suffix = string(" (") + GetInstructionSetName(set) + ")";
+        kernel(GetMisplacedTileCountKernel(set), GetMisplacedTileCount, "MisplacedTileCountBatch" + suffix);
+        kernel(GetManhattanDistanceKernel(set), GetManhattanDistance, "ManhattanDistanceBatch" + suffix);
+    }
+
+    // Screening successors: pack all children of a state, then evaluate them at once.
+    NPuzzleProblem problem(states[0], NPuzzleGoal::DefaultGoal());
+    auto operators = problem.getOperators();
+    double ns = measure([&] {
+        NPuzzlePackedState successors[4];
+        int distances[4], sum = 0;
+        for (size_t i = 0; i < count / 16; i++)
+        {
+            size_t n = 0;
+            for (auto& action : operators)
+            {
+                auto res = action(states[i]);
+                if (res.isSucceeded())
+                    successors[n++] = packState(res.getState());
+            }
+            GetManhattanDistanceBatch(successors, distances, n);
+            for (size_t j = 0; j < n; j++)
+                sum += distances[j];
+        }
+        sink = sum;
+    }, count / 16);
+    cout << "  " << setw(36) << left << "Successors (expand + batch)" << fixed << setprecision(2) << ns << endl;
+    cout << endl;
+}
+
+// The goal state of all search benchmarks.
+NPuzzleState standardGoal() { return NPuzzleGoal::DefaultGoal(); }
+
+// Generate solvable instances by random walks from the goal state.
+vector<NPuzzleState> randomInstances(size_t count, int walkLength, unsigned seed)
+{
+    mt19937 rng(seed);
+    NPuzzleProblem problem(standardGoal(), standardGoal());
+    auto operators = problem.getOperators();
+
+    vector<NPuzzleState> instances;
+    for (size_t i = 0; i < count; i++)
+    {
+        auto state = standardGoal();
+        for (int step = 0; step < walkLength; step++)
+        {
+            auto res = operators[rng() % operators.size()](state);
+            if (res.isSucceeded())
+                state = res.getState();
+        }
+        instances.push_back(state);
+    }
+    return instances;
+}
+
+// The instances of all search benchmarks, fewer and easier ones on larger boards.
+// A smaller count takes the first instances of the full set.
+vector<NPuzzleState> standardInstances(size_t count = demonstration == 8 ? 200 : 10)
+{
+    return randomInstances(count, demonstration == 8 ? 1000 : 100, 7);
+}
+
+// Solve every instance and print expansions, time and nodes/second.
+template <class SolveT>
+void reportSearch(const char* name, const vector<NPuzzleState>& instances, SolveT solve)
+{
+    unsigned long nodes = 0;
+    long depthSum = 0;
+    auto start = chrono::steady_clock::now();
+    for (auto& instance : instances)
+    {
+        auto result = solve(instance, nodes);
+        depthSum += result;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "  " << setw(36) << left << name << setw(12) << nodes
+         << setw(10) << fixed << setprecision(3) << seconds
+         << setw(12) << setprecision(0) << nodes / seconds
+         << "total depth " << depthSum << endl;
+}
+
+void benchmarkSearch()
+{
+    auto instances = standardInstances();
+    auto finalState = standardGoal();
+
+    cout << "A* with Manhattan distance on " << instances.size() << " instances:" << endl;
+    cout << "  " << setw(36) << left << "Mode" << setw(12) << "Nodes" << setw(10) << "Seconds"
+         << setw(12) << "Nodes/s" << endl;
+
+    for (size_t batchSize : { 0, 16, 64, 256 })
+    {
+        string name = batchSize ? "Batch expansion (" + to_string(batchSize) + ")" : "One node at a time";
+        // The solver is reused, so its arena is reused across instances.
+        NPuzzleSolver solver;
+        solver.setHeuristicFunction(GetManhattanDistance);
+        solver.setBatchSize(batchSize);
+        reportSearch(name.c_str(), instances, [&](const NPuzzleState& instance, unsigned long& nodes) {
+            auto result = solver.solve(instance, finalState);
+            nodes += solver.getTotalNodesExpanded();
+            return result.getFinalNode().getDepth();
+        });
+    }
+    cout << endl;
+}
+
+// Whether two solvers found the same path with the same counters.
+bool sameSearch(NPuzzleSolver& a, NPuzzleSolver& b)
+{
+    auto pathA = a.getSolutionPath(), pathB = b.getSolutionPath();
+    bool samePath = pathA.size() == pathB.size();
+    for (size_t i = 0; samePath && i < pathA.size(); i++)
+        samePath = pathA[i].getState() == pathB[i].getState() && pathA[i].getDepth() == pathB[i].getDepth();
+    return samePath && a.getTotalNodesExpanded() == b.getTotalNodesExpanded() &&
+           a.getMaxQueueLength() == b.getMaxQueueLength();
+}
+
+void benchmarkCheckpoint()
+{
+    auto instances = standardInstances();
+    auto finalState = standardGoal();
+    const string path = "bench-checkpoint";
+    const unsigned long interval = 100;
+
+    cout << "Resuming from the last checkpoint (every " << interval << " expansions) on "
+         << instances.size() << " instances:" << endl;
+    for (int mode = 0; mode < 3; mode++)
+    {
+        auto configure = [&](NPuzzleSolver& solver) {
+            solver.setHeuristicFunction(GetManhattanDistance);
+            solver.setBatchSize(mode == 1 ? 16 : 0);
+            solver.setPartialExpansion(mode == 2);
+        };
+        NPuzzleSolver uninterrupted, checkpointed;
+        configure(uninterrupted);
+        configure(checkpointed);
+        checkpointed.setCheckpoint(path, interval);
+
+        // A resumed search should end exactly as the uninterrupted one, and a
+        // checkpoint resumed with another heuristic function should be rejected.
+        int resumed = 0, mismatches = 0, unrejected = 0;
+        for (auto& instance : instances)
+        {
+            auto result = uninterrupted.solve(instance, finalState);
+            auto checkpointedResult = checkpointed.solve(instance, finalState);
+            if (checkpointedResult.getFinalNode().getDepth() != result.getFinalNode().getDepth() ||
+                !sameSearch(uninterrupted, checkpointed))
+                mismatches++;
+            // Short searches end before the first checkpoint, which removes the previous one.
+            if (!ifstream(path))
+                continue;
+
+            NPuzzleSolver resuming;
+            configure(resuming);
+            auto resumedResult = resuming.resume(path);
+            resumed++;
+            if (resumedResult.getFinalNode().getDepth() != result.getFinalNode().getDepth() ||
+                !sameSearch(uninterrupted, resuming))
+                mismatches++;
+
+            NPuzzleSolver rejecting;
+            configure(rejecting);
+            rejecting.setHeuristicFunction(GetMisplacedTileCount);
+            if (rejecting.resume(path).isSucceeded() || rejecting.getCheckpointError().empty())
+                unrejected++;
+        }
+
+        const char* names[] = { "One node at a time", "Batch expansion (16)", "EPEA*" };
+        cout << "  " << setw(36) << left << names[mode] << resumed << " resumed, " << mismatches
+             << " different from uninterrupted, " << unrejected << " resumed with another heuristic" << endl;
+    }
+    remove(path.c_str());
+    remove(Checkpoint::GetJournalPath(path).c_str());
+    cout << endl;
+}
+
+void benchmarkPartialExpansion()
+{
+    auto instances = standardInstances();
+    auto finalState = standardGoal();
+
+    cout << "Peak queue length of A* and EPEA* on " << instances.size() << " instances:" << endl;
+    for (auto hFunc : { GetMisplacedTileCount, GetManhattanDistance })
+    {
+        for (bool partialExpansion : { false, true })
+        {
+            NPuzzleSolver solver;
+            solver.setHeuristicFunction(hFunc);
+            solver.setPartialExpansion(partialExpansion);
+
+            unsigned long maxQueueLength = 0;
+            string name = string(partialExpansion ? "EPEA* " : "A* ") +
+                          (hFunc == GetManhattanDistance ? "(Manhattan)" : "(Misplaced)");
+            reportSearch(name.c_str(), instances, [&](const NPuzzleState& instance, unsigned long& nodes) {
+                auto result = solver.solve(instance, finalState);
+                nodes += solver.getTotalNodesExpanded();
+                maxQueueLength += solver.getMaxQueueLength();
+                return result.getFinalNode().getDepth();
+            });
+            cout << "    peak queue length " << maxQueueLength / instances.size() << " on average" << endl;
+        }
+    }
+    cout << endl;
+}
+
+void benchmarkFringe()
+{
+    auto instances = standardInstances();
+    auto finalState = standardGoal();
+
+    cout << "Heap-based A* and Fringe Search with Manhattan distance on " << instances.size() << " instances:" << endl;
+
+    NPuzzleSolver solver;
+    solver.setHeuristicFunction(GetManhattanDistance);
+    // Batch expansion is the optimal one of the heap-based modes.
+    solver.setBatchSize(16);
+    reportSearch("A* (batch expansion, 16)", instances, [&](const NPuzzleState& instance, unsigned long& nodes) {
+        auto result = solver.solve(instance, finalState);
+        nodes += solver.getTotalNodesExpanded();
+        return result.getFinalNode().getDepth();
+    });
+
+    NPuzzleFringeSolver fringeSolver;
+    fringeSolver.setHeuristicFunction(GetManhattanDistance);
+    unsigned long maxQueueLength = 0, iterations = 0;
+    reportSearch("Fringe Search", instances, [&](const NPuzzleState& instance, unsigned long& nodes) {
+        auto result = fringeSolver.solve(instance, finalState);
+        nodes += fringeSolver.getTotalNodesExpanded();
+        maxQueueLength += fringeSolver.getMaxQueueLength();
+        iterations += fringeSolver.getIterations();
+        return result.getFinalNode().getDepth();
+    });
+    cout << "    peak fringe length " << maxQueueLength / instances.size() << ", "
+         << setprecision(1) << static_cast<double>(iterations) / instances.size()
+         << " iterations on average" << endl << endl;
+}
+
+void benchmarkRealTime()
+{
+    auto instances = standardInstances(demonstration == 8 ? 20 : 5);
+    auto finalState = standardGoal();
+    const int maxTrials = 1000;
+
+    cout << "Real-time LRTA* with Manhattan distance on " << instances.size()
+         << " instances, until a trial learns nothing:" << endl;
+    cout << "  " << setw(12) << left << "Lookahead" << setw(16) << "First move (us)" << setw(16) << "First trial"
+         << setw(10) << "Trials" << setw(14) << "Last trial" << "Learned states" << endl;
+
+    for (size_t lookahead : { 1, 16, 256 })
+    {
+        NPuzzleRealTimeSolver solver;
+        solver.setHeuristicFunction(GetManhattanDistance);
+        solver.setLookahead(lookahead);
+
+        double firstMove = 0;
+        unsigned long firstTrial = 0, trials = 0, lastTrial = 0, learned = 0;
+        for (auto& instance : instances)
+        {
+            solver.forget();
+            for (int trial = 0; trial < maxTrials; trial++)
+            {
+                auto start = chrono::steady_clock::now();
+                solver.start(instance, finalState);
+                auto node = solver.step();
+                if (trial == 0)
+                    firstMove += chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+                while (!solver.isFinished())
+                    node = solver.step();
+
+                trials++;
+                if (trial == 0)
+                    firstTrial += node.getDepth();
+                if (solver.getTrialUpdates() == 0 || trial == maxTrials - 1)
+                {
+                    lastTrial += node.getDepth();
+                    break;
+                }
+            }
+            learned += solver.getLearnedCount();
+        }
+
+        cout << "  " << setw(12) << left << lookahead << setw(16) << fixed << setprecision(2)
+             << firstMove / instances.size() << setw(16) << firstTrial << setw(10) << trials
+             << setw(14) << lastTrial << learned << endl;
+    }
+    cout << endl;
+}
+
+void benchmarkLazy()
+{
+    auto instances = standardInstances();
+    auto finalState = standardGoal();
+
+    cout << "Eager and lazy A* with Manhattan distance and linear conflicts on " << instances.size()
+         << " instances:" << endl;
+
+    auto run = [&](const char* name, NPuzzleLazyHeuristic heuristic) {
+        NPuzzleLazySolver solver;
+        solver.setHeuristic(heuristic);
+        unsigned long reinsertions = 0;
+        reportSearch(name, instances, [&](const NPuzzleState& instance, unsigned long& nodes) {
+            auto result = solver.solve(instance, finalState);
+            nodes += solver.getTotalNodesExpanded();
+            reinsertions += solver.getReinsertions();
+            return result.getFinalNode().getDepth();
+        });
+        for (auto& statistic : solver.getHeuristic().getStatistics())
+            cout << "    " << setw(20) << left << statistic.name << setw(12) << statistic.evaluations
+                 << fixed << setprecision(3) << statistic.seconds << " seconds" << endl;
+        cout << "    " << reinsertions << " reinsertions" << endl;
+    };
+
+    run("Manhattan only", NPuzzleLazyHeuristic("Manhattan", GetManhattanDistance));
+
+    // Both heuristics at once, as a single cheap one.
+    NPuzzleLazyHeuristic both("Manhattan", GetManhattanDistance);
+    both.addDeferred("Linear conflict", GetLinearConflictDistance);
+    run("Eager max", NPuzzleLazyHeuristic("Max of both", [&](NPuzzleNode node) { return both.evaluateAll(node); }));
+
+    both.resetStatistics();
+    run("Lazy", both);
+    cout << endl;
+}
+
+void benchmarkFrontier()
+{
+    auto instances = standardInstances();
+    auto finalState = standardGoal();
+
+    cout << "A* and divide-and-conquer BFHS with Manhattan distance on " << instances.size()
+         << " instances:" << endl;
+
+    // Every node generated by A* stays in its parent mapping until the search ends.
+    NPuzzleSolver solver;
+    solver.setHeuristicFunction(GetManhattanDistance);
+    unsigned long maxStoredNodes = 0;
+    reportSearch("A* (parent pointers)", instances, [&](const NPuzzleState& instance, unsigned long& nodes) {
+        auto result = solver.solve(instance, finalState);
+        nodes += solver.getTotalNodesExpanded();
+        maxStoredNodes = max(maxStoredNodes, solver.getTotalNodesExpanded() + 1);
+        return result.getFinalNode().getDepth();
+    });
+    cout << "    peak stored nodes " << maxStoredNodes << endl;
+
+    NPuzzleFrontierSolver frontierSolver;
+    frontierSolver.setHeuristicFunction(GetManhattanDistance);
+    unsigned long searches = 0;
+    maxStoredNodes = 0;
+    reportSearch("BFHS (relay nodes)", instances, [&](const NPuzzleState& instance, unsigned long& nodes) {
+        auto result = frontierSolver.solve(instance, finalState);
+        nodes += frontierSolver.getTotalNodesExpanded();
+        maxStoredNodes = max(maxStoredNodes, frontierSolver.getMaxStoredNodes());
+        searches += frontierSolver.getSearches();
+        return result.getFinalNode().getDepth();
+    });
+    cout << "    peak stored nodes " << maxStoredNodes << ", " << setprecision(1)
+         << static_cast<double>(searches) / instances.size() << " searches on average" << endl << endl;
+}
+
+template <class HeuristicT>
+void compareStaticSearch(const char* name, NPuzzleCostFunction hFunc, const vector<NPuzzleState>& instances)
+{
+    auto finalState = standardGoal();
+    NPuzzleSolver solver;
+    solver.setHeuristicFunction(hFunc);
+    NPuzzleStaticSolver<HeuristicT> staticSolver;
+
+    // Both expand the same nodes, so any difference in counts, depths or paths is a mismatch.
+    int mismatches = 0;
+    for (auto& instance : instances)
+    {
+        auto result = solver.solve(instance, finalState);
+        auto staticResult = staticSolver.solve(instance, finalState);
+        auto path = solver.getSolutionPath(), staticPath = staticSolver.getSolutionPath();
+        bool samePath = path.size() == staticPath.size();
+        for (size_t i = 0; samePath && i < path.size(); i++)
+            samePath = path[i].getState() == staticPath[i].getState() && path[i].getDepth() == staticPath[i].getDepth();
+        if (result.isSucceeded() != staticResult.isSucceeded() || !samePath ||
+            result.getFinalNode().getDepth() != staticResult.getFinalNode().getDepth() ||
+            solver.getTotalNodesExpanded() != staticSolver.getTotalNodesExpanded() ||
+            solver.getMaxQueueLength() != staticSolver.getMaxQueueLength())
+            mismatches++;
+    }
+
+    string runtimeName = string("GeneralSearcher (") + name + ")";
+    reportSearch(runtimeName.c_str(), instances, [&](const NPuzzleState& instance, unsigned long& nodes) {
+        auto result = solver.solve(instance, finalState);
+        nodes += solver.getTotalNodesExpanded();
+        return result.getFinalNode().getDepth();
+    });
+    string staticName = string("StaticSearcher (") + name + ")";
+    reportSearch(staticName.c_str(), instances, [&](const NPuzzleState& instance, unsigned long& nodes) {
+        auto result = staticSolver.solve(instance, finalState);
+        nodes += staticSolver.getTotalNodesExpanded();
+        return result.getFinalNode().getDepth();
+    });
+    cout << "    " << mismatches << " instances with different expansions or paths" << endl;
+}
+
+void benchmarkStaticSearch()
+{
+    auto instances = standardInstances();
+
+    cout << "Runtime and static general searchers on " << instances.size() << " instances:" << endl;
+    cout << "  " << setw(36) << left << "Searcher" << setw(12) << "Nodes" << setw(10) << "Seconds"
+         << setw(12) << "Nodes/s" << endl;
+    compareStaticSearch<NPuzzleStaticHeuristic<GetMisplacedTileCount>>("Misplaced", GetMisplacedTileCount,
+                                                                       instances);
+    compareStaticSearch<NPuzzleStaticHeuristic<GetManhattanDistance>>("Manhattan", GetManhattanDistance,
+                                                                      instances);
+    cout << endl;
+}
+
+void benchmarkPerimeter()
+{
+    auto instances = standardInstances();
+    auto finalState = standardGoal();
+    const int radius = demonstration == 8 ? 16 : 12;
+
+    auto start = chrono::steady_clock::now();
+    auto perimeter = make_shared<const NPuzzlePerimeter>(finalState, radius);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Perimeter of radius " << radius << ": " << perimeter->size() << " states, "
+         << perimeter->getMemoryUsage() / 1024 << " KiB, built in " << fixed << setprecision(3)
+         << seconds << " seconds" << endl;
+
+    cout << "A* (batch expansion, 16) with Manhattan distance on " << instances.size() << " instances:" << endl;
+    for (bool usePerimeter : { false, true })
+    {
+        NPuzzleSolver solver;
+        solver.setHeuristicFunction(GetManhattanDistance);
+        solver.setBatchSize(16);
+        if (usePerimeter)
+            solver.setPerimeter(perimeter);
+        reportSearch(usePerimeter ? "With perimeter" : "Without perimeter", instances,
+            [&](const NPuzzleState& instance, unsigned long& nodes) {
+                auto result = solver.solve(instance, finalState);
+                nodes += solver.getTotalNodesExpanded();
+                return result.getFinalNode().getDepth();
+            });
+    }
+
+    // Every worker has its own solver, all of them share the perimeter.
+    unsigned workers = max(1u, thread::hardware_concurrency());
+    vector<unsigned long> nodes(workers, 0);
+    vector<long> depths(workers, 0);
+    vector<thread> threads;
+    start = chrono::steady_clock::now();
+    for (unsigned worker = 0; worker < workers; worker++)
+    {
+        threads.emplace_back([&, worker] {
+            NPuzzleSolver solver;
+            solver.setHeuristicFunction(GetManhattanDistance);
+            solver.setBatchSize(16);
+            solver.setPerimeter(perimeter);
+            for (size_t i = worker; i < instances.size(); i += workers)
+            {
+                depths[worker] += solver.solve(instances[i], finalState).getFinalNode().getDepth();
+                nodes[worker] += solver.getTotalNodesExpanded();
+            }
+        });
+    }
+    for (auto& worker : threads)
+        worker.join();
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    unsigned long nodeSum = accumulate(nodes.begin(), nodes.end(), 0UL);
+    string name = "With perimeter (" + to_string(workers) + " threads)";
+    cout << "  " << setw(36) << left << name << setw(12) << nodeSum
+         << setw(10) << fixed << setprecision(3) << seconds
+         << setw(12) << setprecision(0) << nodeSum / seconds
+         << "total depth " << accumulate(depths.begin(), depths.end(), 0L) << endl << endl;
+}
+
+void benchmarkBatchFile()
+{
+    const size_t count = 1000000;
+    const string textPath = "bench-instances.txt", binaryPath = "bench-instances.bin";
+    auto states = randomStates(count, 11);
+
+    {
+        ofstream text(textPath);
+        NPuzzleInstanceWriter binary(binaryPath);
+        for (size_t i = 0; i < count; i++)
+        {
+            text << i;
+            for (auto tile : states[i])
+                text << ' ' << tile;
+            text << '\n';
+            binary.write(i, states[i]);
+        }
+    }
+
+    cout << "Reading " << count << " instances:" << endl;
+    long checksum = 0;
+
+    // Parsed by operator>>, as main.cpp reads a puzzle.
+    auto start = chrono::steady_clock::now();
+    {
+        ifstream text(textPath);
+        uint64_t id;
+        NPuzzleState state;
+        while (text >> id)
+        {
+            for (auto& tile : state)
+                text >> tile;
+            checksum += state[0];
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "  " << setw(36) << left << "Text (operator>>)" << fixed << setprecision(3) << seconds << " seconds" << endl;
+
+    start = chrono::steady_clock::now();
+    {
+        NPuzzleInstanceReader binary(binaryPath);
+        for (auto& record : binary)
+            checksum -= record.toState()[0];
+    }
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "  " << setw(36) << left << "Binary (mapped)" << fixed << setprecision(3) << seconds << " seconds" << endl;
+
+    remove(textPath.c_str());
+    remove(binaryPath.c_str());
+    if (checksum != 0)
+        cout << "  The files differ!" << endl;
+    cout << endl;
+}
+
+void benchmarkGenerator()
+{
+    const uint64_t count = 1000000;
+    NPuzzleGenerator generator(7);
+    cout << "Generating instances with " << generator.getThreads() << " threads:" << endl;
+
+    long checksum = 0;
+    auto sink = [&](uint64_t, const NPuzzleState& state) { checksum += state[0]; };
+    auto report = [&](const string& name, double seconds) {
+        cout << "  " << setw(36) << left << name << setw(10) << fixed << setprecision(3) << seconds
+             << setprecision(0) << count / seconds << " instances/s" << endl;
+    };
+
+    auto start = chrono::steady_clock::now();
+    generator.generateUniform(count, sink);
+    report("Uniform", chrono::duration<double>(chrono::steady_clock::now() - start).count());
+
+    start = chrono::steady_clock::now();
+    generator.generateWalk(count, 100, sink);
+    report("Walk (100 moves)", chrono::duration<double>(chrono::steady_clock::now() - start).count());
+
+    // Bucketing solves every candidate, which is only fast for the 8-puzzle.
+    if (demonstration == 8)
+    {
+        start = chrono::steady_clock::now();
+        auto counts = generator.generateByDepth(10, 10, 25, 1000000, [&](int depth, const NPuzzleState&) { checksum += depth; });
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "  " << setw(36) << left << "By depth (10 each of 10 to 25)" << setw(10) << setprecision(3) << seconds
+             << generator.getCandidates() << " candidates solved, "
+             << accumulate(counts.begin(), counts.end(), 0UL) << " kept" << endl;
+    }
+    cout << "  (checksum " << checksum << ")" << endl << endl;
+}
+
+void benchmarkMacro()
+{
+    cout << "Macro-move solver on random boards (moves are counted, not stored):" << endl;
+    cout << "  " << setw(12) << left << "Width" << setw(28) << "Post-processing" << setw(12) << "Moves"
+         << setw(10) << "Seconds" << endl;
+
+    mt19937 rng(11);
+    for (int width : { 10, 50, 100 })
+    {
+        auto goal = NPuzzleBoard::DefaultGoal(width);
+        auto cells = goal.getCells();
+        shuffle(cells.begin(), cells.end(), rng);
+        // Swapping two tiles flips the parity of an unsolvable board.
+        if (!NPuzzleBoard(width, cells).isSolvable(goal))
+            swap(*find(cells.begin(), cells.end(), 1), *find(cells.begin(), cells.end(), 2));
+        NPuzzleBoard board(width, cells);
+
+        for (int mode = 0; mode < 3; mode++)
+        {
+            NPuzzleMacroSolver solver;
+            solver.setOptimizerWindow(mode ? 256 : 0);
+            solver.setShortcutLength(mode == 2 ? 16 : 0);
+
+            unsigned long moves = 0;
+            auto start = chrono::steady_clock::now();
+            solver.solve(board, goal, [&](NPuzzleMove) { moves++; });
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+            const char* names[] = { "None", "Inverse pairs", "Inverse pairs, shortcuts" };
+            cout << "  " << setw(12) << left << width << setw(28) << names[mode] << setw(12) << moves
+                 << setw(10) << fixed << setprecision(3) << seconds << endl;
+        }
+    }
+    cout << endl;
+}
+
+void benchmarkAnytime()
+{
+    auto instances = standardInstances();
+    auto finalState = standardGoal();
+
+    NPuzzleAnytimeSolver solver;
+    solver.setHeuristicFunction(GetManhattanDistance);
+
+    double firstSeconds = 0, firstBound = 0;
+    bool first = false;
+    solver.setImprovementCallback([&](const NPuzzleAnytimeSolver::Improvement& improvement) {
+        if (!first)
+        {
+            firstSeconds += improvement.seconds;
+            firstBound += improvement.bound;
+            first = true;
+        }
+    });
+
+    cout << "Anytime weighted A* with Manhattan distance on " << instances.size() << " instances:" << endl;
+    reportSearch("Until proven optimal", instances, [&](const NPuzzleState& instance, unsigned long& nodes) {
+        first = false;
+        auto result = solver.solve(instance, finalState, chrono::seconds(60));
+        nodes += solver.getTotalNodesExpanded();
+        return result.getFinalNode().getDepth();
+    });
+    cout << "  First solutions took " << setprecision(6) << firstSeconds / instances.size()
+         << " seconds with a bound of " << setprecision(3) << firstBound / instances.size()
+         << " on average." << endl << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    cout << demonstration << "-puzzle benchmark" << endl << endl;
+    benchmarkHeuristicKernels();
+    benchmarkSearch();
+    benchmarkCheckpoint();
+    benchmarkPartialExpansion();
+    benchmarkFringe();
+    benchmarkRealTime();
+    benchmarkLazy();
+    benchmarkFrontier();
+    benchmarkStaticSearch();
+    benchmarkPerimeter();
+    benchmarkBatchFile();
+    benchmarkGenerator();
+    benchmarkMacro();
+    benchmarkAnytime();
+    return 0;
+}
@@ -0,0 +1,279 @@
+/**
+ * \file Microbenchmark.hpp
+ * \brief A small harness timing components in isolation, with hardware counters where available.
+ *
+ * Each case is one implementation of a component. Cases of the same component
+ * are printed side by side, relative to the first one, so an alternative
+ * implementation is compared by adding a case next to the existing one.
+ */
+#ifndef __MICROBENCHMARK__
+#define __MICROBENCHMARK__
+
+#if defined(__linux__)
+#define MICROBENCHMARK_PERF_EVENT
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * \brief Hardware counters of the calling thread, read through \c perf_event_open on Linux.
+ *
+ * Where the counters could not be opened, such as in containers without permission,
+ * isAvailable() is false and nothing is counted.
+ */
+class PerfCounters
+{
+public:
+    //! The number of counters.
+    static constexpr int Count = 4;
+
+    //! Get the name of a counter.
+    static const char* GetName(int index)
+    {
+        static const char* names[Count] = { "cycles", "instructions", "cache-misses", "branch-misses" };
+        return names[index];
+    }
+
+private:
+    int fds[Count];
+    bool available = false;
+
+public:
+    PerfCounters()
+    {
+        std::fill(fds, fds + Count, -1);
+#ifdef MICROBENCHMARK_PERF_EVENT
+        const uint64_t configs[Count] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                          PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+        available = true;
+        for (int i = 0; i < Count && available; i++)
+        {
+            perf_event_attr attr = perf_event_attr();
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.disabled = i == 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            // All counters are in the group of the first one, so they count the same interval.
+            fds[i] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds[0], 0));
+            available = fds[i] >= 0;
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters()
+    {
+#ifdef MICROBENCHMARK_PERF_EVENT
+        for (auto fd : fds)
+            if (fd >= 0)
+                close(fd);
+#endif
+    }
+
+    //! Whether the counters are counting.
+    bool isAvailable() const { return available; }
+
+    //! Reset and start counting.
+    void start()
+    {
+#ifdef MICROBENCHMARK_PERF_EVENT
+        if (!available)
+            return;
+        ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    /**
+     * \brief Stop counting.
+     * \param values Set to the values of all counters since start().
+     */
+    void stop(uint64_t* values)
+    {
+        std::fill(values, values + Count, 0);
+#ifdef MICROBENCHMARK_PERF_EVENT
+        if (!available)
+            return;
+        ioctl(fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        for (int i = 0; i < Count; i++)
+            if (read(fds[i], &values[i], sizeof(values[i])) != sizeof(values[i]))
+                values[i] = 0;
+#endif
+    }
+};
+
+/**
+ * \brief A suite of microbenchmark cases.
+ *
+ * Each case runs a function a few times to warm up, then times a number of
+ * repetitions. The mean, the standard deviation, a 95% confidence interval
+ * (from Student's t-distribution, so it stays valid for few repetitions),
+ * the min and the median of nanoseconds per item are reported, along with
+ * hardware counters per item if available.
+ */
+class Microbenchmark
+{
+public:
+    //! The statistic of a case.
+    struct Measurement
+    {
+        std::string component;
+        std::string implementation;
+        //! Nanoseconds per item.
+        double mean, stddev, min, median;
+        //! Counters per item, see PerfCounters::GetName().
+        double counters[PerfCounters::Count];
+    };
+
+private:
+    struct Case
+    {
+        std::string component;
+        std::string implementation;
+        std::size_t items;
+        std::function<void()> run;
+    };
+
+    std::vector<Case> cases;
+    int warmups = 3;
+    int repetitions = 30;
+    std::string filter;
+
+public:
+    //! Set the number of runs before timing.
+    void setWarmups(int warmups) { this->warmups = warmups; }
+    //! Set the number of timed runs.
+    void setRepetitions(int repetitions) { this->repetitions = std::max(2, repetitions); }
+    //! Only run cases whose component or implementation contains \c filter.
+    void setFilter(const std::string& filter) { this->filter = filter; }
+
+    /**
+     * \brief Add a case.
+     * \param component The component, such as "PriorityQueue".
+     * \param implementation The implementation of the component.
+     * \param items The number of items processed by each run, to report time per item.
+     * \param run The function to be timed, which should take a few milliseconds.
+     */
+    void add(const std::string& component, const std::string& implementation,
+             std::size_t items, std::function<void()> run)
+    {
+        cases.push_back(Case{ component, implementation, items, run });
+    }
+
+    //! Run all cases matching the filter, printing each component as a table.
+    std::vector<Measurement> runAll(std::ostream& out)
+    {
+        PerfCounters counters;
+        out << "Warm-ups " << warmups << ", repetitions " << repetitions << ", hardware counters "
+            << (counters.isAvailable() ? "available" : "not available") << "." << std::endl;
+
+        std::vector<Measurement> measurements;
+        std::string component;
+        double baseline = 0;
+        for (auto& current : cases)
+        {
+            if (!filter.empty() && current.component.find(filter) == std::string::npos &&
+                current.implementation.find(filter) == std::string::npos)
+                continue;
+
+            if (current.component != component)
+            {
+                component = current.component;
+                baseline = 0;
+                out << std::endl << component << " (ns/item):" << std::endl;
+                out << "  " << std::setw(44) << std::left << "Implementation" << std::setw(20) << "Mean (95% CI)"
+                    << std::setw(10) << "Min" << std::setw(10) << "Median" << std::setw(10) << "Speedup";
+                if (counters.isAvailable())
+                    for (int i = 0; i < PerfCounters::Count; i++)
+                        out << std::setw(15) << PerfCounters::GetName(i);
+                out << std::endl;
+            }
+
+            auto measurement = measure(current, counters);
+            if (baseline == 0)
+                baseline = measurement.mean;
+            print(out, measurement, baseline, counters.isAvailable());
+            measurements.push_back(measurement);
+        }
+        return measurements;
+    }
+
+private:
+    Measurement measure(const Case& current, PerfCounters& counters)
+    {
+        for (int i = 0; i < warmups; i++)
+            current.run();
+
+        std::vector<double> samples;
+        uint64_t totals[PerfCounters::Count] = {}, values[PerfCounters::Count];
+        for (int i = 0; i < repetitions; i++)
+        {
+            counters.start();
+            auto start = std::chrono::steady_clock::now();
+            current.run();
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            counters.stop(values);
+
+            samples.push_back(std::chrono::duration<double, std::nano>(elapsed).count() / current.items);
+            for (int j = 0; j < PerfCounters::Count; j++)
+                totals[j] += values[j];
+        }
+
+        auto measurement = Measurement();
+        measurement.component = current.component;
+        measurement.implementation = current.implementation;
+        measurement.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+        double squares = 0;
+        for (auto sample : samples)
+            squares += (sample - measurement.mean) * (sample - measurement.mean);
+        measurement.stddev = std::sqrt(squares / (samples.size() - 1));
+
+        std::sort(samples.begin(), samples.end());
+        measurement.min = samples.front();
+        measurement.median = samples[samples.size() / 2];
+        for (int j = 0; j < PerfCounters::Count; j++)
+            measurement.counters[j] = static_cast<double>(totals[j]) / repetitions / current.items;
+        return measurement;
+    }
+
+    // The 0.975 quantile of Student's t-distribution, for a two-sided 95% interval.
+    static double GetTQuantile(int degreesOfFreedom)
+    {
+        static const double table[30] = {
+            12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+            2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+            2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+        if (degreesOfFreedom <= 30)
+            return table[std::max(1, degreesOfFreedom) - 1];
+
+        // Cornish-Fisher expansion around the normal quantile, accurate to 3 decimals past 30.
+        const double z = 1.959964;
+        double v = degreesOfFreedom;
+        return z + (z * z * z + z) / (4 * v) + (5 * std::pow(z, 5) + 16 * z * z * z + 3 * z) / (96 * v * v);
+    }
+
+    void print(std::ostream& out, const Measurement& measurement, double baseline, bool hasCounters) const
+    {
+        // The confidence interval of the mean, with the t-distribution since the deviation is estimated.
+        double interval = GetTQuantile(repetitions - 1) * measurement.stddev /
+                          std::sqrt(static_cast<double>(repetitions));
+        std::ostringstream mean;
+        mean << std::fixed << std::setprecision(2) << measurement.mean << " +- " << interval;
+
+        out << "  " << std::setw(44) << std::left << measurement.implementation << std::setw(20) << mean.str()
+            << std::fixed << std::setprecision(2) << std::setw(10) << measurement.min
+            << std::setw(10) << measurement.median << "x" << std::setw(9) << baseline / measurement.mean;
+        if (hasCounters)
+            for (int i = 0; i < PerfCounters::Count; i++)
+                out << std::setw(15) << measurement.counters[i];
+        out << std::endl;
+    }
+};
+
+#endif
@@ -0,0 +1,377 @@
+#include <iostream>
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <deque>
+#include <chrono>
+#include <limits>
+#include <sstream>
+#include <fstream>
+#include <thread>
+#include <random>
+#include <iomanip>
+#include <numeric>
+#include <queue>
+#include <string>
+using namespace std;
+
+#include "Arena.hpp"
+#include "PriorityQueue.hpp"
+#include "HashTable.hpp"
+#include "GeneralSearch.hpp"
+#include "StaticSearch.hpp"
+
+#include "NPuzzleSetting.hpp"
+#include "NPuzzleDefinition.hpp"
+#include "NPuzzleUtility.hpp"
+#include "NPuzzleGoal.hpp"
+#include "NPuzzleProblem.hpp"
+#include "NPuzzleHeuristicFunction.hpp"
+#include "NPuzzleHeuristicKernel.hpp"
+#include "NPuzzleOperatorSelection.hpp"
+#include "NPuzzleCheckpoint.hpp"
+#include "NPuzzleHeuristicTable.hpp"
+#include "NPuzzlePerimeter.hpp"
+#include "NPuzzleSolver.hpp"
+#include "NPuzzleAnytimeSolver.hpp"
+#include "NPuzzleFringeSolver.hpp"
+#include "NPuzzleRealTimeSolver.hpp"
+#include "NPuzzleBoard.hpp"
+#include "NPuzzleMacroSolver.hpp"
+#include "NPuzzleLazyHeuristic.hpp"
+#include "NPuzzleLazySolver.hpp"
+#include "NPuzzleFrontierSolver.hpp"
+#include "NPuzzleBatchFile.hpp"
+#include "NPuzzleGenerator.hpp"
+#include "NPuzzleStaticSolver.hpp"
+#include "Microbenchmark.hpp"
+using namespace NPuzzle;
+
+// Keeps results alive, so the optimizer does not drop the work being timed.
+volatile long sink;
+
+// States reached by random walks, as a search meets them.
+vector<NPuzzleState> walkStates(size_t count, uint64_t seed)
+{
+    vector<NPuzzleState> states;
+    NPuzzleGenerator generator(seed);
+    generator.generateWalk(count, 50, [&](uint64_t, const NPuzzleState& state) { states.push_back(state); });
+    return states;
+}
+
+// A sequence of queue operations, like the ones of A* with a consistent h(n): each node
+// removed adds 1 to 3 children, whose f(n) is either the same as its parent or 2 larger.
+struct QueueWorkload
+{
+    vector<NPuzzleNode> initial;
+    vector<uint8_t> children;
+    vector<uint8_t> raises;
+
+    explicit QueueWorkload(const vector<NPuzzleState>& states, size_t pops)
+    {
+        mt19937 rng(3);
+        for (size_t i = 0; i < 1024; i++)
+            initial.push_back(NPuzzleNode(states[i % states.size()], 10 + rng() % 4, 10 + rng() % 6));
+        for (size_t i = 0; i < pops; i++)
+        {
+            children.push_back(static_cast<uint8_t>(1 + rng() % 3));
+            for (int j = 0; j < 3; j++)
+                raises.push_back(rng() % 3 == 0 ? 2 : 0);
+        }
+    }
+
+    // Run the sequence on a queue with push(), pop(), top() and empty().
+    template <class QueueT>
+    long run(QueueT& queue) const
+    {
+        long sum = 0;
+        for (auto& node : initial)
+            queue.push(node);
+        for (size_t i = 0; i < children.size(); i++)
+        {
+            auto node = queue.top();
+            queue.pop();
+            sum += node.getDepth();
+            for (int j = 0; j < children[i]; j++)
+            {
+                // g(n) grows by 1, and h(n) changes by 1, either way.
+                int raise = raises[i * 3 + j];
+                queue.push(NPuzzleNode(node.getState(), node.getDepth() + 1, node.getHeuristic() + raise - 1));
+            }
+        }
+        return sum;
+    }
+};
+
+// A bucket per f(n), the last node pushed comes first within a bucket.
+class BucketQueue
+{
+private:
+    vector<vector<NPuzzleNode>> buckets;
+    size_t minF = 0;
+    size_t count = 0;
+
+public:
+    void push(const NPuzzleNode& node)
+    {
+        size_t f = node.getDepth() + node.getHeuristic();
+        if (f >= buckets.size())
+            buckets.resize(f + 1);
+        buckets[f].push_back(node);
+        minF = count++ ? min(minF, f) : f;
+    }
+    const NPuzzleNode& top()
+    {
+        while (buckets[minF].empty())
+            minF++;
+        return buckets[minF].back();
+    }
+    void pop()
+    {
+        top();
+        buckets[minF].pop_back();
+        count--;
+    }
+    bool empty() const { return count == 0; }
+};
+
+void addPriorityQueueCases(Microbenchmark& suite, const vector<NPuzzleState>& states)
+{
+    const size_t pops = 100000;
+    auto workload = make_shared<QueueWorkload>(states, pops);
+    auto compare = [](const NPuzzleNode& a, const NPuzzleNode& b) { return NPuzzleSolver::FFunc(a) > NPuzzleSolver::FFunc(b); };
+
+    suite.add("PriorityQueue push/pop", "PriorityQueue (binary heap)", pops, [=] {
+        NPuzzleQueue queue(compare);
+        sink = workload->run(queue);
+    });
+    suite.add("PriorityQueue push/pop", "std::priority_queue", pops, [=] {
+        priority_queue<NPuzzleNode, vector<NPuzzleNode>, decltype(compare)> queue(compare);
+        sink = workload->run(queue);
+    });
+    suite.add("PriorityQueue push/pop", "Bucket queue by f(n)", pops, [=] {
+        BucketQueue queue;
+        sink = workload->run(queue);
+    });
+}
+
+// FNV-1a over the tiles.
+struct FnvHash
+{
+    size_t operator()(const NPuzzleState& state) const
+    {
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        for (auto tile : state)
+            hash = (hash ^ static_cast<uint64_t>(tile)) * 0x100000001B3ULL;
+        return static_cast<size_t>(hash);
+    }
+};
+
+// 4 bits per tile, spread by Fibonacci hashing, as NPuzzle::NPuzzleHeuristicTable does.
+struct PackedHash
+{
+    size_t operator()(const NPuzzleState& state) const
+    {
+        uint64_t key = 0;
+        for (auto tile : state)
+            key = (key << 4) | static_cast<uint64_t>(tile);
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 32);
+    }
+};
+
+template <class HashT>
+void addHashCase(Microbenchmark& suite, const string& name, shared_ptr<const vector<NPuzzleState>> states)
+{
+    suite.add("Hashing", name, states->size(), [=] {
+        size_t sum = 0;
+        HashT hasher;
+        for (auto& state : *states)
+            sum += hasher(state);
+        sink = static_cast<long>(sum);
+    });
+}
+
+// Collisions of full hashes, and of buckets in a power-of-2 table as large as the set.
+template <class HashT>
+void printCollisions(const string& name, const vector<NPuzzleState>& distinct)
+{
+    HashT hasher;
+    unordered_set<size_t> hashes;
+    size_t buckets = 1;
+    while (buckets < distinct.size())
+        buckets *= 2;
+    vector<bool> used(buckets, false);
+    size_t usedBuckets = 0;
+    for (auto& state : distinct)
+    {
+        auto hash = hasher(state);
+        hashes.insert(hash);
+        if (!used[hash & (buckets - 1)])
+        {
+            used[hash & (buckets - 1)] = true;
+            usedBuckets++;
+        }
+    }
+
+    // Random hashes leave 1/e of the buckets empty.
+    double expected = buckets * (1 - exp(-static_cast<double>(distinct.size()) / buckets));
+    cout << "  " << setw(36) << left << name << setw(14) << distinct.size() - hashes.size()
+         << fixed << setprecision(3) << usedBuckets / expected << endl;
+}
+
+void addSetCases(Microbenchmark& suite, const vector<NPuzzleState>& distinct)
+{
+    // Half of the probes hit, half of them miss.
+    auto members = make_shared<vector<NPuzzleState>>(distinct.begin(), distinct.begin() + distinct.size() / 2);
+    auto probes = make_shared<vector<NPuzzleState>>(distinct);
+    shuffle(probes->begin(), probes->end(), mt19937(5));
+
+    auto states = make_shared<unordered_set<NPuzzleState>>(members->begin(), members->end());
+    suite.add("Set probes", "unordered_set<NPuzzleState>", probes->size(), [=] {
+        long hits = 0;
+        for (auto& state : *probes)
+            hits += states->count(state);
+        sink = hits;
+    });
+
+    // NPuzzleSolver keeps only the hashes of visited states.
+    auto hashes = make_shared<unordered_set<size_t>>();
+    for (auto& state : *members)
+        hashes->insert(hash<NPuzzleState>()(state));
+    suite.add("Set probes", "unordered_set<size_t> of hashes", probes->size(), [=] {
+        long hits = 0;
+        for (auto& state : *probes)
+            hits += hashes->count(hash<NPuzzleState>()(state));
+        sink = hits;
+    });
+
+    auto table = make_shared<NPuzzleHeuristicTable>();
+    table->reset(NPuzzleGoal::DefaultGoal());
+    for (auto& state : *members)
+        table->set(state, 1);
+    suite.add("Set probes", "NPuzzleHeuristicTable (open addressing)", probes->size(), [=] {
+        long hits = 0;
+        int value;
+        for (auto& state : *probes)
+            hits += table->find(state, value);
+        sink = hits;
+    });
+}
+
+void addMoveCases(Microbenchmark& suite, shared_ptr<const vector<NPuzzleState>> states)
+{
+    suite.add("Moves (all successors)", "NPuzzleProblem operators", states->size(), [=] {
+        NPuzzleProblem problem(NPuzzleGoal::DefaultGoal(), NPuzzleGoal::DefaultGoal());
+        auto operators = problem.getOperators();
+        long sum = 0;
+        for (auto& state : *states)
+        {
+            for (auto& action : operators)
+            {
+                auto res = action(state);
+                if (res.isSucceeded())
+                    sum += res.getState()[0];
+            }
+        }
+        sink = sum;
+    });
+
+    suite.add("Moves (all successors)", "Swapping the blank directly", states->size(), [=] {
+        long sum = 0;
+        for (auto& state : *states)
+        {
+            long blank = find(state.begin(), state.end(), 0) - state.begin();
+            int row, col;
+            indexToMatrix(blank, row, col);
+            long targets[4];
+            int count = 0;
+            if (col > 0) targets[count++] = blank - 1;
+            if (col + 1 < matrixDemonstration) targets[count++] = blank + 1;
+            if (row > 0) targets[count++] = blank - matrixDemonstration;
+            if (row + 1 < matrixDemonstration) targets[count++] = blank + matrixDemonstration;
+            for (int i = 0; i < count; i++)
+            {
+                auto next = state;
+                swap(next[blank], next[targets[i]]);
+                sum += next[0];
+            }
+        }
+        sink = sum;
+    });
+}
+
+void addHeuristicCases(Microbenchmark& suite, shared_ptr<const vector<NPuzzleState>> states)
+{
+    // Each function is a component of its own, only alternative implementations are compared.
+    auto scalar = [&](const string& component, const string& name, NPuzzleCostFunction hFunc) {
+        suite.add(component, name, states->size(), [=] {
+            long sum = 0;
+            for (auto& state : *states)
+                sum += hFunc(NPuzzleNode(state, 0));
+            sink = sum;
+        });
+    };
+    scalar("Heuristic: misplaced tiles", "GetMisplacedTileCount", GetMisplacedTileCount);
+    scalar("Heuristic: linear conflicts", "GetLinearConflictDistance", GetLinearConflictDistance);
+    scalar("Heuristic: Manhattan distance", "GetManhattanDistance", GetManhattanDistance);
+
+    if (!packable)
+        return;
+    auto packed = make_shared<vector<NPuzzlePackedState>>();
+    for (auto& state : *states)
+        packed->push_back(packState(state));
+    auto out = make_shared<vector<int>>(states->size());
+    suite.add("Heuristic: Manhattan distance", "GetManhattanDistanceBatch", states->size(), [=] {
+        GetManhattanDistanceBatch(packed->data(), out->data(), packed->size());
+        sink = (*out)[0];
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    Microbenchmark suite;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        string option = argv[i];
+        if (option == "--filter")
+            suite.setFilter(argv[i + 1]);
+        else if (option == "--repetitions")
+            suite.setRepetitions(stoi(argv[i + 1]));
+        else if (option == "--warmups")
+            suite.setWarmups(stoi(argv[i + 1]));
+    }
+
+    cout << demonstration << "-puzzle microbenchmark" << endl;
+    auto states = make_shared<const vector<NPuzzleState>>(walkStates(1 << 16, 1));
+
+    // Distinct states, for sets and collisions.
+    auto uniform = vector<NPuzzleState>();
+    NPuzzleGenerator(2).generateUniform(1 << 17, [&](uint64_t, const NPuzzleState& state) { uniform.push_back(state); });
+    sort(uniform.begin(), uniform.end());
+    uniform.erase(unique(uniform.begin(), uniform.end()), uniform.end());
+
+    addPriorityQueueCases(suite, *states);
+    addHashCase<hash<NPuzzleState>>(suite, "std::hash<NPuzzleState>", states);
+    addHashCase<FnvHash>(suite, "FNV-1a", states);
+    if (packable)
+        addHashCase<PackedHash>(suite, "Packed, Fibonacci hashing", states);
+    addSetCases(suite, uniform);
+    addMoveCases(suite, states);
+    addHeuristicCases(suite, states);
+    suite.runAll(cout);
+
+    cout << endl << "Hash collisions of " << uniform.size() << " distinct states:" << endl;
+    cout << "  " << setw(36) << left << "Hash" << setw(14) << "Collisions" << "Used buckets / expected" << endl;
+    printCollisions<hash<NPuzzleState>>("std::hash<NPuzzleState>", uniform);
+    printCollisions<FnvHash>("FNV-1a", uniform);
+    if (packable)
+        printCollisions<PackedHash>("Packed, Fibonacci hashing", uniform);
+    return 0;
+}
@@ -0,0 +1,175 @@
+/**
+ * \file Arena.hpp
+ * \brief An arena which bump-allocates memory from large chunks,
+ * and an STL allocator based on it.
+ */
+#ifndef __ARENA__
+#define __ARENA__
+
+/**
+ * \brief An arena which bump-allocates memory from large chunks.
+ *
+ * Memory is never freed one allocation at a time. Instead, reset() makes
+ * all chunks available again in O(1), and release() frees them.
+ *
+ * Objects living in an arena are not destructed by it, so they should
+ * either be trivially destructible or own nothing but arena memory.
+ */
+class Arena
+{
+public:
+    //! The default size of a chunk, 4 MiB.
+    static constexpr std::size_t DefaultChunkSize = 1 << 22;
+
+private:
+    struct Chunk
+    {
+        std::unique_ptr<char[]> memory;
+        std::size_t size;
+    };
+
+    std::vector<Chunk> chunks;
+    std::size_t chunkSize;
+    // The chunk being allocated from, and the offset of free memory in it.
+    std::size_t current = 0;
+    std::size_t offset = 0;
+
+public:
+    /**
+     * \param chunkSize The size of chunks, larger allocations get a chunk on their own.
+     */
+    explicit Arena(std::size_t chunkSize = DefaultChunkSize) : chunkSize(chunkSize) {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * \brief Allocate memory from the arena.
+     * \param size The size in bytes.
+     * \param alignment The alignment, should be a power of 2.
+     * \return The allocated memory.
+     */
+    void* allocate(std::size_t size, std::size_t alignment)
+    {
+        while (current < chunks.size())
+        {
+            auto base = reinterpret_cast<std::uintptr_t>(chunks[current].memory.get());
+            auto aligned = (base + offset + alignment - 1) & ~(alignment - 1);
+            if (aligned + size <= base + chunks[current].size)
+            {
+                offset = aligned + size - base;
+                return reinterpret_cast<void*>(aligned);
+            }
+
+            // Not enough room, move on to the next chunk.
+            current++;
+            offset = 0;
+        }
+
+        // No chunks left, so add a new one.
+        Chunk chunk;
+        chunk.size = std::max(chunkSize, size + alignment);
+        chunk.memory.reset(new char[chunk.size]);
+        chunks.push_back(std::move(chunk));
+        return allocate(size, alignment);
+    }
+
+    /**
+     * \brief Give memory back to the arena.
+     *
+     * Only the latest allocation could actually be reused, such as the buffer
+     * of a growing \c std::vector, others are kept until reset().
+     */
+    void deallocate(void* pointer, std::size_t size)
+    {
+        if (current < chunks.size() &&
+            static_cast<char*>(pointer) + size == chunks[current].memory.get() + offset)
+            offset -= size;
+    }
+
+    //! Make all memory available again in O(1), chunks are kept for reuse.
+    void reset()
+    {
+        current = 0;
+        offset = 0;
+    }
+
+    //! Free all chunks.
+    void release()
+    {
+        chunks.clear();
+        reset();
+    }
+
+    //! The total size of chunks owned by the arena.
+    std::size_t getCapacity() const
+    {
+        std::size_t capacity = 0;
+        for (auto& chunk : chunks)
+            capacity += chunk.size;
+        return capacity;
+    }
+
+    /**
+     * \brief Construct an object in the arena.
+     * \return The constructed object, which would never be destructed by the arena.
+     */
+    template <class T, class... ArgsT>
+    T* create(ArgsT&&... args)
+    {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<ArgsT>(args)...);
+    }
+};
+
+/**
+ * \brief An STL allocator allocating from an Arena.
+ * \tparam T The value type to be allocated.
+ *
+ * An allocator without an arena falls back to the global \c new and \c delete,
+ * so containers using it work the same as the ones using \c std::allocator.
+ */
+template <class T>
+class ArenaAllocator
+{
+    template <class U> friend class ArenaAllocator;
+
+public:
+    typedef T value_type;
+
+private:
+    Arena* arena;
+
+public:
+    ArenaAllocator() : arena(nullptr) {}
+    /**
+     * \param arena The arena to allocate from, \c nullptr to use the global \c new.
+     */
+    explicit ArenaAllocator(Arena* arena) : arena(arena) {}
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    //! Get the arena to allocate from.
+    Arena* getArena() const { return arena; }
+
+    T* allocate(std::size_t n)
+    {
+        if (!arena)
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* pointer, std::size_t n)
+    {
+        if (!arena)
+            ::operator delete(pointer);
+        else
+            arena->deallocate(pointer, n * sizeof(T));
+    }
+
+    template <class U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <class U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
+
+#endif
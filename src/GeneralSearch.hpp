@@ -121,7 +121,7 @@ public:
  * It stores the final node with queue node type \c NodeT.
  *
  * SearchResult could only be created by its static creators
- * SearchResult::Failure and SearchResult::Success.
+ * SearchResult::Failure, SearchResult::Rejected and SearchResult::Success.
  */
 template <class NodeT>
 class SearchResult
@@ -130,11 +130,12 @@ class SearchResult
 
 private:
     bool succeeded;
+    bool rejected;
     NodeT finalNode;
 
 private:
-    SearchResult() : succeeded(false) {}
-    SearchResult(NodeT finalNode) : succeeded(true), finalNode(finalNode) {}
+    SearchResult(bool rejected = false) : succeeded(false), rejected(rejected) {}
+    SearchResult(NodeT finalNode) : succeeded(true), rejected(false), finalNode(finalNode) {}
 
 public:
     /**
@@ -142,12 +143,19 @@ public:
      * \return True if yes, false if not.
      */
     bool isSucceeded() const { return succeeded; }
+    /**
+     * \brief Whether the problem was rejected as unsolvable without searching.
+     * \return True if rejected, false if searched.
+     */
+    bool isRejected() const { return rejected; }
     //! The final node if there exists a solution.
     NodeT getFinalNode() const { return finalNode; }
 
 public:
     //! Create a failed result, that is no solution.
     static SearchResultT Failure() { return SearchResultT(); }
+    //! Create a rejected result, that is no solution and no search was needed to know it.
+    static SearchResultT Rejected() { return SearchResultT(true); }
     /**
      * \brief Create a successful result, that is existing a solution.
      * \param finalNode The final Node.
@@ -174,20 +182,76 @@ public:
 private:
     NodeT currentNode;
     ResultVectorT result;
+    ExpandCostT nextCost;
 
 public:
     /**
      * \brief Create a expanding result.
      * \param expandedNode The node expanded.
      * \param result The states expanded and their cost from the node.
+     * \param nextCost The least cost of the children left out by operator selection.
      */
-    ExpandResult(NodeT expandedNode, ResultVectorT result) :
-        currentNode(expandedNode), result(result) {}
+    ExpandResult(NodeT expandedNode, ResultVectorT result,
+                 ExpandCostT nextCost = std::numeric_limits<ExpandCostT>::max()) :
+        currentNode(expandedNode), result(result), nextCost(nextCost) {}
 
     //! Get the expanded node.
     NodeT getCurrentNode() const { return currentNode; }
     //! Get states expanded and their cost from the node.
     ResultVectorT getResult() const { return result; }
+    /**
+     * \brief Get the least cost, such as \c f(n), of the children left out by operator selection.
+     *
+     * It is the max value of \c ExpandCostT if no child is left out.
+     */
+    ExpandCostT getNextCost() const { return nextCost; }
+};
+
+/**
+ * \brief The result of expanding a batch of nodes in the queue.
+ * \tparam StateT The state type used in a Problem.
+ * \tparam NodeT The node type used in a GeneralSearcher.
+ * \tparam ExpandCostT The expanding cost type used in a Problem.
+ *
+ * States expanded from all nodes are stored in one contiguous buffer,
+ * and each of them records the index of the node it is expanded from.
+ */
+template <class StateT, class NodeT, class ExpandCostT>
+class ExpandBatchResult
+{
+public:
+    typedef typename ExpandResult<StateT, NodeT, ExpandCostT>::ResultPairT   ResultPairT;
+    typedef typename ExpandResult<StateT, NodeT, ExpandCostT>::ResultVectorT ResultVectorT;
+
+private:
+    std::vector<NodeT> expandedNodes;
+    ResultVectorT result;
+    std::vector<std::size_t> parentIndex;
+
+public:
+    //! Remove all nodes and states, but keep the capacity of buffers.
+    void clear()
+    {
+        expandedNodes.clear();
+        result.clear();
+        parentIndex.clear();
+    }
+
+    //! Add an expanded node.
+    void addNode(const NodeT& node) { expandedNodes.push_back(node); }
+    //! Add a state expanded from the last added node.
+    void addResult(const ResultPairT& pair)
+    {
+        result.push_back(pair);
+        parentIndex.push_back(expandedNodes.size() - 1);
+    }
+
+    //! Get the expanded nodes.
+    const std::vector<NodeT>& getNodes() const { return expandedNodes; }
+    //! Get states expanded and their cost from all nodes.
+    const ResultVectorT& getResult() const { return result; }
+    //! Get the index (in getNodes()) of the node which the i-th state expanded from.
+    std::size_t getParentIndex(std::size_t i) const { return parentIndex[i]; }
 };
 
 /**
@@ -195,16 +259,18 @@ public:
  * \tparam StateT The state type used in a Problem.
  * \tparam NodeT The node type used in a PriorityQueue.
  * \tparam ExpandCostT The expanding cost type used in a Problem.
+ * \tparam QueueAllocatorT The allocator used by the PriorityQueue.
  *
  * For 8-puzzle, the \c StateT is \c std::array, the \c ExpandCostT is \c int.
  */
-template <class StateT, class NodeT, typename ExpandCostT>
+template <class StateT, class NodeT, typename ExpandCostT,
+          class QueueAllocatorT = std::allocator<NodeT>>
 class GeneralSearcher
 {
 public:
     // Use a custom priority queue, since it's impossible to dynamically change
     // the comparison function using the one in STL.
-    typedef PriorityQueue<NodeT>                            QueueT;
+    typedef PriorityQueue<NodeT, QueueAllocatorT>           QueueT;
     //! Refer to \ref PriorityQueue::ComparatorT.
     typedef typename QueueT::ComparatorT                    QueueComparatorT;
     typedef ExpandResult<StateT, NodeT, ExpandCostT>        ExpandResultT;
@@ -221,6 +287,19 @@ public:
      * \endcode
      */
     typedef std::function<void(QueueT&, ExpandResultT)>     QueuingFunctionT;
+    typedef ExpandBatchResult<StateT, NodeT, ExpandCostT>   ExpandBatchResultT;
+    /**
+     * \brief The queuing function type for a batch of expanded nodes.
+     *
+     * It should be the following form:
+     * \code
+     * void batchQueuingFunciton(QueueT& queue, const ExpandBatchResultT& result)
+     * {
+     *     ...
+     * }
+     * \endcode
+     */
+    typedef std::function<void(QueueT&, const ExpandBatchResultT&)> BatchQueuingFunctionT;
     typedef SearchResult<NodeT>                             SearchResultT;
     /**
      * \brief The type of the function converting \c StateT to \c NodeT.
@@ -246,6 +325,28 @@ public:
      * \endcode
      */
     typedef std::function<StateT(NodeT)>                    ToStateT;
+    //! Bit \c i is set if the \c i-th operator of the problem is applied.
+    typedef uint32_t                                        OperatorMaskT;
+    //! The operators selected for a node, used in partial expansion.
+    struct OperatorSelection
+    {
+        //! The operators applied, so the other children are never generated.
+        OperatorMaskT operators;
+        //! The least cost of the children left out, see ExpandResult::getNextCost().
+        ExpandCostT nextCost;
+    };
+    /**
+     * \brief The type of the operator selection function, used in partial expansion.
+     *
+     * It should be the following form:
+     * \code
+     * OperatorSelection selectOperators(const NodeT& node)
+     * {
+     *     ...
+     * }
+     * \endcode
+     */
+    typedef std::function<OperatorSelection(const NodeT&)>  OperatorSelectionT;
 
 private:
     typedef Problem<StateT, ExpandCostT>                    ProblemT;
@@ -258,19 +359,42 @@ private:
     ToStateT toState;
     // Queue comparator.
     QueueComparatorT queueComparator;
+    // Queue allocator.
+    QueueAllocatorT queueAllocator;
 
 private:
     ExpandResultT expand(NodeT node, std::vector<OperatorT> operators)
+    {
+        return expand(node, operators, OperatorSelection{ ~OperatorMaskT(), std::numeric_limits<ExpandCostT>::max() });
+    }
+
+    ExpandResultT expand(NodeT node, std::vector<OperatorT> operators, OperatorSelection selection)
     {
         ExpandResultVectorT result;
-        for (auto action : operators)
+        for (std::size_t i = 0; i < operators.size(); i++)
         {
-            auto res = action(toState(node));
+            // Skip operators not selected, the ones past the bits of the mask are always applied.
+            if (i < std::numeric_limits<OperatorMaskT>::digits && !(selection.operators >> i & 1))
+                continue;
+
+            auto res = operators[i](toState(node));
             // Only expand nodes on which the operation succeeded.
             if (res.isSucceeded())
                 result.push_back(std::make_pair(res.getState(), res.getCost()));
         }
-        return ExpandResultT(node, result);
+        return ExpandResultT(node, result, selection.nextCost);
+    }
+
+    void expand(NodeT node, const std::vector<OperatorT>& operators, ExpandBatchResultT& batch)
+    {
+        batch.addNode(node);
+        for (auto& action : operators)
+        {
+            auto res = action(toState(node));
+            // Only expand nodes on which the operation succeeded.
+            if (res.isSucceeded())
+                batch.addResult(std::make_pair(res.getState(), res.getCost()));
+        }
     }
 
 public:
@@ -278,17 +402,50 @@ public:
      * \param makeNode The function converts \c StateT to \c NodeT.
      * \param toState The function converts \c NodeT to \c StateT.
      * \param queueComparator The comparator used in PriorityQueue.
+     * \param queueAllocator The allocator used in PriorityQueue.
      */
-    GeneralSearcher(NodeMakerT makeNode, ToStateT toState, QueueComparatorT queueComparator)
-        : makeNode(makeNode), toState(toState), queueComparator(queueComparator) {}
+    GeneralSearcher(NodeMakerT makeNode, ToStateT toState, QueueComparatorT queueComparator,
+                    QueueAllocatorT queueAllocator = QueueAllocatorT())
+        : makeNode(makeNode), toState(toState), queueComparator(queueComparator),
+          queueAllocator(queueAllocator) {}
 
     //! <tt>function general-search(problem, QUEUEING-FUNCTION)</tt>
     SearchResultT generalSearch(ProblemT* problem, QueuingFunctionT queueingFunction)
     {
         // nodes = MAKE-QUEUE(MAKE-NODE(problem, INITIAL-STATE)
-        QueueT nodes(queueComparator);  
+        QueueT nodes = makeQueue();
         nodes.push(makeNode(problem->getInitialState())); // Enqueue initial state
 
+        return generalSearch(problem, queueingFunction, nodes);
+    }
+
+    //! Make an empty queue with the comparator and allocator of this searcher.
+    QueueT makeQueue() const { return QueueT(queueComparator, queueAllocator); }
+
+    /**
+     * \brief Continue the general search from a queue, such as one restored from a checkpoint.
+     * \param problem The problem to be solved.
+     * \param queueingFunction The queuing function.
+     * \param nodes The queue to continue from.
+     */
+    SearchResultT generalSearch(ProblemT* problem, QueuingFunctionT queueingFunction, QueueT& nodes)
+    {
+        return generalSearch(problem, queueingFunction, nullptr, nodes);
+    }
+
+    /**
+     * \brief The general search, but only the selected operators are applied to each node.
+     * \param problem The problem to be solved.
+     * \param queueingFunction The queuing function.
+     * \param selectOperators The operator selection function, \c nullptr to apply all operators.
+     * \param nodes The queue to continue from.
+     *
+     * It is the base of partial expansion, where a node is expanded again for
+     * the children left out, see \ref OperatorSelectionT.
+     */
+    SearchResultT generalSearch(ProblemT* problem, QueuingFunctionT queueingFunction,
+                                OperatorSelectionT selectOperators, QueueT& nodes)
+    {
         while (true)
         {
             // if EMPTY(nodes) then return "failure"
@@ -304,7 +461,57 @@ public:
                 return SearchResultT::Success(node);
 
             // nodes = QUEUING-FUNCTION(nodes, EXPAND(node, problem.OPERATORS))
-            queueingFunction(nodes, expand(node, problem->getOperators()));
+            queueingFunction(nodes, selectOperators ? expand(node, problem->getOperators(), selectOperators(node))
+                                                    : expand(node, problem->getOperators()));
+        }
+    }
+
+    /**
+     * \brief The general search, but removes a batch of nodes at a time.
+     * \param problem The problem to be solved.
+     * \param queueingFunction The queuing function for a batch of expanded nodes.
+     * \param maxBatchSize The max number of nodes removed at a time.
+     *
+     * All nodes removed at a time share the best priority in the queue, so the
+     * first one passes the goal test is as good as the one generalSearch() returns.
+     */
+    SearchResultT batchSearch(ProblemT* problem, BatchQueuingFunctionT queueingFunction,
+                              std::size_t maxBatchSize)
+    {
+        QueueT nodes = makeQueue();
+        nodes.push(makeNode(problem->getInitialState()));
+
+        return batchSearch(problem, queueingFunction, maxBatchSize, nodes);
+    }
+
+    //! Continue the batch search from a queue, such as one restored from a checkpoint.
+    SearchResultT batchSearch(ProblemT* problem, BatchQueuingFunctionT queueingFunction,
+                              std::size_t maxBatchSize, QueueT& nodes)
+    {
+        auto operators = problem->getOperators();
+        ExpandBatchResultT batch;
+
+        while (true)
+        {
+            if (nodes.isEmpty())
+                return SearchResultT::Failure();
+
+            // Remove nodes with the same priority as the front one.
+            batch.clear();
+            auto front = nodes.top();
+            do
+            {
+                auto node = nodes.top();
+                nodes.pop();
+
+                if (problem->goalTest(toState(node)))
+                    return SearchResultT::Success(node);
+
+                expand(node, operators, batch);
+            } while (!nodes.isEmpty() && batch.getNodes().size() < maxBatchSize &&
+                     !queueComparator(nodes.top(), front));
+
+            queueingFunction(nodes, batch);
         }
     }
 };
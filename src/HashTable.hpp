@@ -0,0 +1,150 @@
+/**
+ * \file HashTable.hpp
+ * \brief An open-addressing hash table with linear probing.
+ */
+#ifndef __HASH_TABLE__
+#define __HASH_TABLE__
+
+/**
+ * \brief A hash function spreading another one by Fibonacci hashing.
+ * \tparam KeyT The key type.
+ * \tparam BaseHashT The hash function spread, which may be poor in the low bits.
+ */
+template <class KeyT, class BaseHashT = std::hash<KeyT>>
+struct FibonacciHash
+{
+    std::size_t operator()(const KeyT& key) const
+    {
+        return static_cast<std::size_t>((static_cast<uint64_t>(BaseHashT()(key)) * 0x9E3779B97F4A7C15ULL) >> 32);
+    }
+};
+
+/**
+ * \brief An open-addressing hash table with linear probing.
+ * \tparam KeyT The key type, compared by \c ==.
+ * \tparam ValueT The value type.
+ * \tparam HashT The hash function, the table uses its low bits.
+ *
+ * Keys and values are stored in place, so the slot of a key is known before
+ * probing it, and could be prefetched. There is no deletion, and the table
+ * doubles when half full.
+ */
+template <class KeyT, class ValueT, class HashT = FibonacciHash<KeyT>>
+class HashTable
+{
+private:
+    struct Slot
+    {
+        KeyT key;
+        ValueT value;
+    };
+
+    // Slots holding emptyKey are empty, the value of emptyKey itself is kept aside.
+    std::vector<Slot> slots;
+    std::size_t initialCapacity;
+    std::size_t count = 0;
+    KeyT emptyKey;
+    bool hasEmptyKey = false;
+    ValueT emptyKeyValue = ValueT();
+
+public:
+    /**
+     * \param initialCapacity The initial number of slots, should be a power of 2.
+     * \param emptyKey The key marking empty slots, which is still allowed as a key.
+     */
+    explicit HashTable(std::size_t initialCapacity = 1024, const KeyT& emptyKey = KeyT())
+        : slots(initialCapacity, Slot{ emptyKey, ValueT() }), initialCapacity(initialCapacity), emptyKey(emptyKey) {}
+
+    //! Remove all values, and shrink to the initial capacity.
+    void clear()
+    {
+        if (slots.size() > initialCapacity)
+            std::vector<Slot>(initialCapacity, Slot{ emptyKey, ValueT() }).swap(slots);
+        else
+            std::fill(slots.begin(), slots.end(), Slot{ emptyKey, ValueT() });
+        count = 0;
+        hasEmptyKey = false;
+    }
+
+    //! The number of values stored.
+    std::size_t size() const { return count + (hasEmptyKey ? 1 : 0); }
+    //! The memory used by the table in bytes.
+    std::size_t getMemoryUsage() const { return slots.size() * sizeof(Slot); }
+
+    /**
+     * \brief Find the value of a key.
+     * \param key The key.
+     * \return The value, \c nullptr if not found.
+     */
+    const ValueT* find(const KeyT& key) const
+    {
+        if (key == emptyKey)
+            return hasEmptyKey ? &emptyKeyValue : nullptr;
+        auto& slot = slots[probe(key)];
+        return slot.key == emptyKey ? nullptr : &slot.value;
+    }
+
+    /**
+     * \brief Insert a value if the key is new.
+     * \param key The key.
+     * \param value The value.
+     * \return The value of the key, and whether it was inserted.
+     */
+    std::pair<ValueT*, bool> insert(const KeyT& key, const ValueT& value)
+    {
+        if (key == emptyKey)
+        {
+            bool inserted = !hasEmptyKey;
+            if (inserted)
+                emptyKeyValue = value;
+            hasEmptyKey = true;
+            return std::make_pair(&emptyKeyValue, inserted);
+        }
+
+        if ((count + 1) * 2 > slots.size())
+            grow();
+        auto& slot = slots[probe(key)];
+        if (slot.key == key)
+            return std::make_pair(&slot.value, false);
+        slot.key = key;
+        slot.value = value;
+        count++;
+        return std::make_pair(&slot.value, true);
+    }
+
+    //! Set the value of a key, inserting it if new.
+    void set(const KeyT& key, const ValueT& value) { *insert(key, value).first = value; }
+
+    //! Fetch the slot of a key into cache ahead of probing it.
+    void prefetch(const KeyT& key) const
+    {
+#if defined(__GNUC__)
+        __builtin_prefetch(&slots[slotOf(key)]);
+#endif
+    }
+
+private:
+    std::size_t slotOf(const KeyT& key) const { return HashT()(key) & (slots.size() - 1); }
+
+    // The slot holding the key, or the empty slot it would be inserted into.
+    std::size_t probe(const KeyT& key) const
+    {
+        auto i = slotOf(key);
+        while (!(slots[i].key == emptyKey) && !(slots[i].key == key))
+            i = (i + 1) & (slots.size() - 1);
+        return i;
+    }
+
+    void grow()
+    {
+        std::vector<Slot> old(slots.size() * 2, Slot{ emptyKey, ValueT() });
+        old.swap(slots);
+        for (auto& slot : old)
+        {
+            if (!(slot.key == emptyKey))
+                slots[probe(slot.key)] = slot;
+        }
+    }
+};
+
+#endif
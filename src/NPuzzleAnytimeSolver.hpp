@@ -0,0 +1,351 @@
+/**
+ * \file NPuzzleAnytimeSolver.hpp
+ * \brief The anytime solver for N-Puzzle problem, based on ARA*.
+ *
+ * The solver returns a first solution fast by weighting \c h(n), then lowers
+ * the weight and reuses its search effort to tighten the suboptimality bound,
+ * until the solution is proven optimal or the deadline is reached.
+ */
+#ifndef __NPUZZLE_ANYTIME_SOLVER__
+#define __NPUZZLE_ANYTIME_SOLVER__
+
+namespace NPuzzle
+{
+    /**
+     * \brief The anytime solver for N-Puzzle problem, based on ARA*.
+     *
+     * Each iteration searches with <tt>f(n) = g(n) + w * h(n)</tt>. States whose
+     * \c g(n) drops after they are expanded are kept aside as inconsistent, and
+     * queued again for the next iteration with a smaller \c w, rather than
+     * searching from scratch.
+     *
+     * With an admissible and consistent \c h(n), the cost of every solution
+     * is at most \c bound times the optimal one.
+     */
+    class NPuzzleAnytimeSolver
+    {
+    public:
+        typedef std::chrono::steady_clock ClockT;
+
+        //! A solution found by the solver, or a tighter bound of it.
+        struct Improvement
+        {
+            //! The depth of the solution.
+            int depth;
+            //! The weight of h(n) in the iteration which found the solution.
+            double weight;
+            //! The proven suboptimality bound of the solution.
+            double bound;
+            //! The total amount of nodes expanded so far.
+            unsigned long nodesExpanded;
+            //! Seconds elapsed since the search started.
+            double seconds;
+        };
+
+        /**
+         * \brief The type of callbacks on each improvement.
+         *
+         * It should be the following form:
+         * \code
+         * void onImprovement(const NPuzzleAnytimeSolver::Improvement& improvement)
+         * {
+         *     ...
+         * }
+         * \endcode
+         */
+        typedef std::function<void(const Improvement&)> ImprovementCallbackT;
+
+    private:
+        static constexpr int InfiniteDepth = std::numeric_limits<int>::max();
+
+        // Everything known about a state.
+        struct Entry
+        {
+            int depth = InfiniteDepth;
+            int heuristic = 0;
+            NPuzzleState parent;
+            // The iteration in which the state was expanded, -1 if never.
+            int closedIteration = -1;
+            bool inconsistent = false;
+        };
+
+        // Parameters
+        NPuzzleCostFunction hFunc;
+        double initialWeight = 3.0;
+        double weightStep = 0.5;
+        ImprovementCallbackT onImprovement;
+
+        // Statistic
+        unsigned long totalNodesExpanded = 0;
+        bool timedOut = false;
+
+        // States of last search, in canonical labels.
+        std::unordered_map<NPuzzleState, Entry> table;
+        std::vector<NPuzzleState> inconsistentStates;
+        NPuzzleState initialState;
+        double weight = 1.0;
+        int iteration = 0;
+
+        // The best solution found so far.
+        NPuzzleGoal goal;
+        NPuzzleNode finalNode;
+        std::vector<NPuzzleNode> solutionPath;
+        double bound = std::numeric_limits<double>::infinity();
+
+    public:
+        //! Get the total amount of nodes expanded.
+        unsigned long getTotalNodesExpanded() const { return totalNodesExpanded; }
+        //! Whether last search was stopped by the deadline before proving optimality.
+        bool isTimedOut() const { return timedOut; }
+        //! Get the proven suboptimality bound of the best solution, infinity if there is none.
+        double getBound() const { return bound; }
+
+        //! Get the heuristic function (\c h(n)).
+        NPuzzleCostFunction getHeuristicFunction() const { return hFunc; }
+        //! Set the heuristic function (\c h(n)), which should be admissible and consistent.
+        void setHeuristicFunction(NPuzzleCostFunction hFunc) { this->hFunc = hFunc; }
+
+        /**
+         * \brief Set how the weight of \c h(n) changes between iterations.
+         * \param initialWeight The weight of the first iteration, at least 1.
+         * \param weightStep The weight is lowered by this value after each iteration.
+         */
+        void setWeights(double initialWeight, double weightStep)
+        {
+            this->initialWeight = std::max(1.0, initialWeight);
+            this->weightStep = weightStep;
+        }
+
+        //! Set the callback called on each improvement.
+        void setImprovementCallback(ImprovementCallbackT onImprovement) { this->onImprovement = onImprovement; }
+
+        //! Get the path to the best solution if exists. The path starts with the initial state.
+        std::vector<NPuzzleNode> getSolutionPath() const { return solutionPath; }
+
+        /**
+         * \brief Solve the N-Puzzle problem before a deadline.
+         * \param initialState The intital state.
+         * \param finalState The goal state.
+         * \param deadline The search stops at this time even if it is not proven optimal.
+         * \return The best solution found, or a failed SearchResult if none was found in time.
+         */
+        NPuzzleSearchResult solve(NPuzzleState initialState, NPuzzleState finalState,
+                                  ClockT::time_point deadline)
+        {
+            auto start = ClockT::now();
+
+            // Clear the information last search left.
+            table.clear();
+            inconsistentStates.clear();
+            solutionPath.clear();
+            finalNode = NPuzzleNode();
+            totalNodesExpanded = 0;
+            timedOut = false;
+            bound = std::numeric_limits<double>::infinity();
+
+            goal = NPuzzleGoal(finalState);
+            if (!goal.isSolvable(initialState))
+                return NPuzzleSearchResult::Rejected();
+            initialState = goal.relabel(initialState);
+            this->initialState = initialState;
+            auto canonicalGoal = goal.getCanonicalGoal();
+
+            NPuzzleProblem problem(initialState, canonicalGoal);
+            auto operators = problem.getOperators();
+            NPuzzleQueue open([&](const NPuzzleNode& a, const NPuzzleNode& b) {
+                // Less key has higher priority, prefer the deeper one on ties.
+                double keyA = key(a), keyB = key(b);
+                return keyA > keyB || (keyA == keyB && a.getDepth() < b.getDepth());
+            });
+
+            weight = initialWeight;
+            iteration = 0;
+            auto& initialEntry = table[initialState];
+            initialEntry.depth = 0;
+            initialEntry.heuristic = hFunc(NPuzzleNode(initialState, 0));
+            open.push(NPuzzleNode(initialState, 0, initialEntry.heuristic));
+
+            while (true)
+            {
+                if (!improvePath(open, operators, canonicalGoal, deadline))
+                {
+                    timedOut = true;
+                    break;
+                }
+
+                auto found = table.find(canonicalGoal);
+                if (found == table.end())
+                    break; // Exhausted, no solution.
+
+                // Keep the shorter one between the new solution and the best so far.
+                int bestDepth = finalNode.getDepth();
+                if (bestDepth == NPuzzleNode::FailureDepth || found->second.depth < bestDepth)
+                    recordSolution(canonicalGoal);
+
+                // Every state is either expanded or in OPEN or INCONS, so the least
+                // g(n) + h(n) among OPEN and INCONS is a lower bound of the optimal depth.
+                int depth = finalNode.getDepth();
+                double newBound = std::min(weight, depth / lowerBound(open, depth));
+                if (depth != bestDepth || newBound < bound)
+                {
+                    bound = std::min(bound, newBound);
+                    if (onImprovement)
+                    {
+                        double seconds = std::chrono::duration<double>(ClockT::now() - start).count();
+                        onImprovement(Improvement{ depth, weight, bound, totalNodesExpanded, seconds });
+                    }
+                }
+
+                if (weight <= 1.0 || bound <= 1.0)
+                    break;
+
+                // Lower the weight, and move INCONS into OPEN.
+                weight = std::max(1.0, weight - weightStep);
+                iteration++;
+                rebuildOpen(open);
+            }
+
+            if (finalNode.getDepth() == NPuzzleNode::FailureDepth)
+                return NPuzzleSearchResult::Failure();
+            return NPuzzleSearchResult::Success(goal.restore(finalNode));
+        }
+
+        /**
+         * \brief Solve the N-Puzzle problem within a time budget.
+         * \param initialState The intital state.
+         * \param finalState The goal state.
+         * \param budget The search stops after this duration even if it is not proven optimal.
+         * \return The best solution found, or a failed SearchResult if none was found in time.
+         */
+        template <class RepT, class PeriodT>
+        NPuzzleSearchResult solve(NPuzzleState initialState, NPuzzleState finalState,
+                                  std::chrono::duration<RepT, PeriodT> budget)
+        {
+            return solve(initialState, finalState,
+                         ClockT::now() + std::chrono::duration_cast<ClockT::duration>(budget));
+        }
+
+    private:
+        double key(const NPuzzleNode& node) const
+        {
+            return node.getDepth() + weight * node.getHeuristic();
+        }
+
+        // Whether a queued node is outdated or already expanded in this iteration.
+        bool isStale(const NPuzzleNode& node) const
+        {
+            auto& entry = table.at(node.getState());
+            return node.getDepth() != entry.depth || entry.closedIteration == iteration;
+        }
+
+        // Expand nodes until the goal is better than everything in OPEN.
+        // Returns false if the deadline is reached.
+        bool improvePath(NPuzzleQueue& open, const std::vector<NPuzzleProblem::OperatorT>& operators,
+                         const NPuzzleState& canonicalGoal, ClockT::time_point deadline)
+        {
+            for (unsigned long expanded = 0; !open.isEmpty(); )
+            {
+                auto node = open.top();
+                if (isStale(node))
+                {
+                    open.pop();
+                    continue;
+                }
+
+                auto found = table.find(canonicalGoal);
+                if (found != table.end() && found->second.depth <= key(node))
+                    return true;
+
+                // Checking the clock is cheap, but not free.
+                if (expanded++ % 256 == 0 && ClockT::now() >= deadline)
+                    return false;
+
+                open.pop();
+                auto state = node.getState();
+                table[state].closedIteration = iteration;
+
+                for (auto& action : operators)
+                {
+                    auto res = action(state);
+                    if (!res.isSucceeded())
+                        continue;
+
+                    auto nextState = res.getState();
+                    int depth = node.getDepth() + res.getCost();
+                    auto inserted = table.insert(std::make_pair(nextState, Entry()));
+                    auto& entry = inserted.first->second;
+                    if (inserted.second)
+                        entry.heuristic = hFunc(NPuzzleNode(nextState, depth));
+
+                    if (depth >= entry.depth)
+                        continue;
+
+                    entry.depth = depth;
+                    entry.parent = state;
+                    totalNodesExpanded++;
+
+                    if (entry.closedIteration != iteration)
+                        open.push(NPuzzleNode(nextState, depth, entry.heuristic));
+                    else if (!entry.inconsistent)
+                    {
+                        entry.inconsistent = true;
+                        inconsistentStates.push_back(nextState);
+                    }
+                }
+            }
+            return true;
+        }
+
+        // The least g(n) + h(n) in OPEN and INCONS, or goalDepth if both are empty.
+        double lowerBound(const NPuzzleQueue& open, int goalDepth) const
+        {
+            int least = goalDepth;
+            for (auto& node : open.getContainer())
+                if (!isStale(node))
+                    least = std::min(least, node.getDepth() + node.getHeuristic());
+            for (auto& state : inconsistentStates)
+            {
+                auto& entry = table.at(state);
+                least = std::min(least, entry.depth + entry.heuristic);
+            }
+            return std::max(least, 1);
+        }
+
+        // Queue everything in OPEN and INCONS again with the current weight.
+        void rebuildOpen(NPuzzleQueue& open)
+        {
+            NPuzzleQueue rebuilt(open.getComparator());
+            for (auto& node : open.getContainer())
+                if (node.getDepth() == table.at(node.getState()).depth)
+                    rebuilt.push(node);
+            for (auto& state : inconsistentStates)
+            {
+                auto& entry = table.at(state);
+                entry.inconsistent = false;
+                rebuilt.push(NPuzzleNode(state, entry.depth, entry.heuristic));
+            }
+            inconsistentStates.clear();
+            open = std::move(rebuilt);
+        }
+
+        // Trace parents of the goal, since they could change in later iterations.
+        void recordSolution(const NPuzzleState& canonicalGoal)
+        {
+            // Parents always have less g(n), so the trace ends at the initial state.
+            solutionPath.clear();
+            for (auto state = canonicalGoal; state != initialState; )
+            {
+                state = table.at(state).parent;
+                solutionPath.push_back(goal.restore(NPuzzleNode(state, 0)));
+            }
+
+            // The path now is in reverse order, so we reverse it back.
+            std::reverse(solutionPath.begin(), solutionPath.end());
+            for (std::size_t i = 0; i < solutionPath.size(); i++)
+                solutionPath[i].setDepth(static_cast<int>(i));
+            finalNode = NPuzzleNode(canonicalGoal, static_cast<int>(solutionPath.size()));
+        }
+    };
+}
+
+#endif
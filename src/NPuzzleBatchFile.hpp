@@ -0,0 +1,529 @@
+/**
+ * \file NPuzzleBatchFile.hpp
+ * \brief Binary files of instances and results, for solving large batches.
+ *
+ * - An instance file holds a NPuzzle::BatchFile::Header and then one
+ *   NPuzzle::BatchFile::InstanceRecord per instance.
+ * - A result file holds a NPuzzle::BatchFile::Header and then one
+ *   NPuzzle::BatchFile::ResultRecord per result, each followed by its moves,
+ *   4 moves per byte, padded to 8 bytes. Results are only appended.
+ *
+ * The number of records is never stored, so both files could be appended to.
+ * Records are in the native layout of the build, and both files are mapped into
+ * memory directly when read. Text versions of both are converted by the functions
+ * in NPuzzle::BatchFile, as the batch tool in \c tools/ does.
+ */
+#ifndef __NPUZZLE_BATCH_FILE__
+#define __NPUZZLE_BATCH_FILE__
+
+#if defined(__unix__) || defined(__APPLE__)
+#define NPUZZLE_BATCH_FILE_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace NPuzzle
+{
+    //! The binary layout of instance and result files.
+    namespace BatchFile
+    {
+        static_assert(demonstration < 255, "Tiles are stored in bytes.");
+
+        //! Identifies an instance file, and its layout version.
+        constexpr char InstanceMagic[8] = { 'N', 'P', 'Z', 'I', 'N', 'S', 'T', '1' };
+        //! Identifies a result file, and its layout version.
+        constexpr char ResultMagic[8] = { 'N', 'P', 'Z', 'R', 'S', 'L', 'T', '1' };
+
+        //! The header of both files.
+        struct Header
+        {
+            char magic[8];
+            //! NPuzzle::demonstration of the build which wrote it.
+            uint32_t puzzleSize;
+            //! The size of NPuzzle::BatchFile::InstanceRecord or NPuzzle::BatchFile::ResultRecord.
+            uint32_t recordSize;
+
+            static Header Make(const char* magic, std::size_t recordSize)
+            {
+                auto header = Header();
+                std::copy(magic, magic + sizeof(header.magic), header.magic);
+                header.puzzleSize = demonstration;
+                header.recordSize = static_cast<uint32_t>(recordSize);
+                return header;
+            }
+
+            //! Whether the file was written by a build with the same layout.
+            bool isCompatible(const char* magic, std::size_t recordSize) const
+            {
+                return std::equal(this->magic, this->magic + sizeof(this->magic), magic) &&
+                       puzzleSize == static_cast<uint32_t>(demonstration) &&
+                       this->recordSize == recordSize;
+            }
+        };
+
+        //! An instance, with tiles stored in bytes.
+        struct InstanceRecord
+        {
+            uint64_t id;
+            uint8_t state[demonstration + 1];
+
+            static InstanceRecord FromState(uint64_t id, const NPuzzleState& state)
+            {
+                auto record = InstanceRecord();
+                record.id = id;
+                for (int i = 0; i <= demonstration; i++)
+                    record.state[i] = static_cast<uint8_t>(state[i]);
+                return record;
+            }
+
+            NPuzzleState toState() const
+            {
+                NPuzzleState result;
+                for (int i = 0; i <= demonstration; i++)
+                    result[i] = state[i];
+                return result;
+            }
+        };
+
+        //! How the search for an instance ended, the same as NPuzzle::NPuzzleSearchResult.
+        enum class ResultStatus : uint32_t { Solved, Failed, Rejected };
+        //! The number of values of NPuzzle::BatchFile::ResultStatus.
+        constexpr uint32_t ResultStatusCount = 3;
+
+        //! A result, followed by \c (length + 3) / 4 bytes of moves, padded to 8 bytes.
+        struct ResultRecord
+        {
+            uint64_t id;
+            ResultStatus status;
+            //! The number of moves, 0 if not solved.
+            uint32_t length;
+            uint64_t nodesExpanded;
+            double seconds;
+        };
+
+        //! Get the bytes of moves following a result, including the padding.
+        inline std::size_t GetMoveBytes(uint32_t length) { return ((length + 3) / 4 + 7) / 8 * 8; }
+
+        //! Get the letter of a move in text, the direction the blank moves to.
+        inline char GetMoveLetter(NPuzzleMove move) { return "LRUD"[static_cast<uint8_t>(move)]; }
+
+        //! Get the move of the blank from a state to the next one.
+        inline NPuzzleMove GetMoveBetween(const NPuzzleState& state, const NPuzzleState& next)
+        {
+            auto from = std::find(state.begin(), state.end(), 0) - state.begin();
+            auto to = std::find(next.begin(), next.end(), 0) - next.begin();
+            if (to == from - 1)
+                return NPuzzleMove::Left;
+            if (to == from + 1)
+                return NPuzzleMove::Right;
+            return to < from ? NPuzzleMove::Up : NPuzzleMove::Down;
+        }
+    }
+
+    /**
+     * \brief A read-only file mapped into memory where possible, or read into a buffer.
+     */
+    class NPuzzleMappedFile
+    {
+    private:
+        const char* data = nullptr;
+        std::size_t size = 0;
+        std::vector<char> buffer;
+        void* mapping = nullptr;
+
+    public:
+        /**
+         * \param path The path of the file.
+         */
+        explicit NPuzzleMappedFile(const std::string& path)
+        {
+#ifdef NPUZZLE_BATCH_FILE_POSIX
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                return;
+
+            struct stat status;
+            if (fstat(fd, &status) == 0 && status.st_size > 0)
+            {
+                mapping = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapping == MAP_FAILED)
+                    mapping = nullptr;
+                else
+                {
+                    // Records are read in order.
+                    madvise(mapping, static_cast<std::size_t>(status.st_size), MADV_SEQUENTIAL);
+                    size = static_cast<std::size_t>(status.st_size);
+                    data = static_cast<const char*>(mapping);
+                }
+            }
+            close(fd);
+            if (mapping)
+                return;
+#endif
+            // Fallback to reading the file into memory.
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file)
+                return;
+            buffer.resize(static_cast<std::size_t>(file.tellg()));
+            file.seekg(0);
+            if (file.read(buffer.data(), buffer.size()))
+            {
+                data = buffer.data();
+                size = buffer.size();
+            }
+        }
+
+        NPuzzleMappedFile(const NPuzzleMappedFile&) = delete;
+        NPuzzleMappedFile& operator=(const NPuzzleMappedFile&) = delete;
+
+        ~NPuzzleMappedFile()
+        {
+#ifdef NPUZZLE_BATCH_FILE_POSIX
+            if (mapping)
+                munmap(mapping, size);
+#endif
+        }
+
+        //! Get the contents, \c nullptr if the file could not be read or is empty.
+        const char* getData() const { return data; }
+        //! Get the size of the contents in bytes.
+        std::size_t getSize() const { return size; }
+    };
+
+    /**
+     * \brief Reads an instance file, without copying the instances.
+     */
+    class NPuzzleInstanceReader
+    {
+    private:
+        NPuzzleMappedFile file;
+        const BatchFile::InstanceRecord* records = nullptr;
+        std::size_t count = 0;
+        std::string error;
+
+    public:
+        /**
+         * \param path The path of the instance file.
+         */
+        explicit NPuzzleInstanceReader(const std::string& path) : file(path)
+        {
+            auto header = reinterpret_cast<const BatchFile::Header*>(file.getData());
+            if (file.getSize() < sizeof(BatchFile::Header) ||
+                !header->isCompatible(BatchFile::InstanceMagic, sizeof(BatchFile::InstanceRecord)))
+            {
+                error = "Not a compatible instance file: " + path;
+                return;
+            }
+
+            auto bytes = file.getSize() - sizeof(BatchFile::Header);
+            if (bytes % sizeof(BatchFile::InstanceRecord) != 0)
+            {
+                error = "Truncated instance file: " + path;
+                return;
+            }
+            records = reinterpret_cast<const BatchFile::InstanceRecord*>(file.getData() + sizeof(BatchFile::Header));
+            count = bytes / sizeof(BatchFile::InstanceRecord);
+        }
+
+        //! Get the error of reading the file, empty if none.
+        std::string getError() const { return error; }
+        //! Get the number of instances.
+        std::size_t size() const { return count; }
+        //! Get an instance.
+        const BatchFile::InstanceRecord& operator[](std::size_t index) const { return records[index]; }
+        //! Get the first instance, for iterating over them.
+        const BatchFile::InstanceRecord* begin() const { return records; }
+        //! Get the end of instances.
+        const BatchFile::InstanceRecord* end() const { return records + count; }
+    };
+
+    /**
+     * \brief Appends instances to an instance file.
+     */
+    class NPuzzleInstanceWriter
+    {
+    private:
+        std::ofstream file;
+
+    public:
+        /**
+         * \param path The path of the instance file, which is created if not existing.
+         */
+        explicit NPuzzleInstanceWriter(const std::string& path)
+            : file(path, std::ios::binary | std::ios::app)
+        {
+            if (file.tellp() == 0)
+            {
+                auto header = BatchFile::Header::Make(BatchFile::InstanceMagic, sizeof(BatchFile::InstanceRecord));
+                file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            }
+        }
+
+        //! Append an instance.
+        void write(uint64_t id, const NPuzzleState& state)
+        {
+            auto record = BatchFile::InstanceRecord::FromState(id, state);
+            file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        }
+
+        //! Whether all instances are written so far.
+        bool isGood() const { return file.good(); }
+    };
+
+    /**
+     * \brief Reads a result file, without copying the results.
+     */
+    class NPuzzleResultReader
+    {
+    private:
+        NPuzzleMappedFile file;
+        std::size_t offset = sizeof(BatchFile::Header);
+        std::string error;
+
+    public:
+        /**
+         * \param path The path of the result file.
+         */
+        explicit NPuzzleResultReader(const std::string& path) : file(path)
+        {
+            auto header = reinterpret_cast<const BatchFile::Header*>(file.getData());
+            if (file.getSize() < sizeof(BatchFile::Header) ||
+                !header->isCompatible(BatchFile::ResultMagic, sizeof(BatchFile::ResultRecord)))
+                error = "Not a compatible result file: " + path;
+        }
+
+        //! Get the error of reading the file, empty if none.
+        std::string getError() const { return error; }
+
+        /**
+         * \brief Read the next result.
+         * \param record Set to the result.
+         * \param moves Set to its moves, 4 moves per byte, the first one in the lowest bits.
+         * \return Whether there is a next result. If a result is truncated or has an unknown status,
+         * the error is set.
+         */
+        bool next(const BatchFile::ResultRecord*& record, const uint8_t*& moves)
+        {
+            if (!error.empty() || offset == file.getSize())
+                return false;
+
+            record = reinterpret_cast<const BatchFile::ResultRecord*>(file.getData() + offset);
+            if (file.getSize() - offset < sizeof(BatchFile::ResultRecord) ||
+                file.getSize() - offset - sizeof(BatchFile::ResultRecord) < BatchFile::GetMoveBytes(record->length))
+            {
+                error = "Truncated result file";
+                return false;
+            }
+            if (static_cast<uint32_t>(record->status) >= BatchFile::ResultStatusCount)
+            {
+                error = "Unknown result status in result file";
+                return false;
+            }
+            moves = reinterpret_cast<const uint8_t*>(record + 1);
+            offset += sizeof(BatchFile::ResultRecord) + BatchFile::GetMoveBytes(record->length);
+            return true;
+        }
+
+        //! Get a move of a result read by next().
+        static NPuzzleMove getMove(const uint8_t* moves, uint32_t index)
+        {
+            return static_cast<NPuzzleMove>((moves[index / 4] >> (index % 4 * 2)) & 3);
+        }
+    };
+
+    /**
+     * \brief Appends results to a result file, through a buffer.
+     */
+    class NPuzzleResultWriter
+    {
+    private:
+        std::ofstream file;
+        std::vector<uint8_t> moves;
+
+    public:
+        /**
+         * \param path The path of the result file, which is created if not existing.
+         */
+        explicit NPuzzleResultWriter(const std::string& path)
+            : file(path, std::ios::binary | std::ios::app)
+        {
+            if (file.tellp() == 0)
+            {
+                auto header = BatchFile::Header::Make(BatchFile::ResultMagic, sizeof(BatchFile::ResultRecord));
+                file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            }
+        }
+
+        /**
+         * \brief Append a result.
+         * \param record The result, whose \c length should match \c path.
+         * \param path The moves of the blank.
+         */
+        void write(const BatchFile::ResultRecord& record, const std::vector<NPuzzleMove>& path)
+        {
+            moves.assign(BatchFile::GetMoveBytes(record.length), 0);
+            for (std::size_t i = 0; i < path.size(); i++)
+                moves[i / 4] |= static_cast<uint8_t>(static_cast<uint8_t>(path[i]) << (i % 4 * 2));
+
+            file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+            file.write(reinterpret_cast<const char*>(moves.data()), moves.size());
+        }
+
+        //! Whether all results are written so far.
+        bool isGood() const { return file.good(); }
+    };
+
+    namespace BatchFile
+    {
+        /**
+         * \brief Convert instances from text, one per line.
+         * \param in Lines of an ID and \c demonstration + 1 tiles, or tiles only,
+         * where the ID is the line number starting from 0.
+         * \param out The instance file.
+         * \return The number of instances converted, or -1 on a malformed line,
+         * including one whose tiles are not a permutation of 0 to \c demonstration.
+         */
+        inline long ConvertInstancesFromText(std::istream& in, NPuzzleInstanceWriter& out)
+        {
+            std::string line;
+            std::vector<unsigned long long> numbers;
+            long count = 0;
+            for (uint64_t lineNumber = 0; std::getline(in, line); lineNumber++)
+            {
+                std::istringstream fields(line);
+                numbers.clear();
+                for (unsigned long long number; fields >> number; )
+                    numbers.push_back(number);
+                if (numbers.empty())
+                    continue;
+
+                bool hasId = numbers.size() == static_cast<std::size_t>(demonstration) + 2;
+                if (!fields.eof() || (!hasId && numbers.size() != static_cast<std::size_t>(demonstration) + 1))
+                    return -1;
+
+                // Check the range before narrowing, so large values could not wrap into valid tiles.
+                NPuzzleState state;
+                for (int i = 0; i <= demonstration; i++)
+                {
+                    if (numbers[i + hasId] > static_cast<unsigned long long>(demonstration))
+                        return -1;
+                    state[i] = static_cast<int>(numbers[i + hasId]);
+                }
+                if (!isPermutation(state))
+                    return -1;
+                out.write(hasId ? numbers[0] : lineNumber, state);
+                count++;
+            }
+            return count;
+        }
+
+        //! Convert instances to text, an ID and the tiles per line.
+        inline void ConvertInstancesToText(const NPuzzleInstanceReader& in, std::ostream& out)
+        {
+            std::string line;
+            for (auto& record : in)
+            {
+                line = std::to_string(record.id);
+                for (int i = 0; i <= demonstration; i++)
+                    line += ' ' + std::to_string(record.state[i]);
+                line += '\n';
+                out << line;
+            }
+        }
+
+        //! Get the names of NPuzzle::BatchFile::ResultStatus in text.
+        inline const char* const* GetStatusNames()
+        {
+            static const char* statusNames[ResultStatusCount] = { "solved", "failed", "rejected" };
+            return statusNames;
+        }
+
+        /**
+         * \brief Convert results to text, one per line.
+         *
+         * Each line is the ID, the status, the number of moves, the moves as
+         * letters of NPuzzle::BatchFile::GetMoveLetter() (\c - if none),
+         * the nodes expanded and the seconds.
+         */
+        inline void ConvertResultsToText(NPuzzleResultReader& in, std::ostream& out)
+        {
+            auto statusNames = GetStatusNames();
+            const ResultRecord* record;
+            const uint8_t* moves;
+            std::string line;
+            while (in.next(record, moves))
+            {
+                line = std::to_string(record->id) + ' ' + statusNames[static_cast<uint32_t>(record->status)] +
+                       ' ' + std::to_string(record->length) + ' ';
+                for (uint32_t i = 0; i < record->length; i++)
+                    line += GetMoveLetter(NPuzzleResultReader::getMove(moves, i));
+                if (record->length == 0)
+                    line += '-';
+                line += ' ' + std::to_string(record->nodesExpanded) + ' ' + std::to_string(record->seconds) + '\n';
+                out << line;
+            }
+        }
+
+        /**
+         * \brief Convert results from text, in the format of ConvertResultsToText().
+         * \param in Lines of results.
+         * \param out The result file.
+         * \return The number of results converted, or -1 on a malformed line.
+         */
+        inline long ConvertResultsFromText(std::istream& in, NPuzzleResultWriter& out)
+        {
+            auto statusNames = GetStatusNames();
+            std::string line, status, letters;
+            std::vector<NPuzzleMove> path;
+            long count = 0;
+            while (std::getline(in, line))
+            {
+                std::istringstream fields(line);
+                auto record = ResultRecord();
+                if (!(fields >> record.id))
+                {
+                    // Skip blank lines.
+                    if (line.find_first_not_of(" \t\r") == std::string::npos)
+                        continue;
+                    return -1;
+                }
+
+                std::string extra;
+                if (!(fields >> status >> record.length >> letters >> record.nodesExpanded >> record.seconds) ||
+                    fields >> extra)
+                    return -1;
+
+                auto name = std::find_if(statusNames, statusNames + ResultStatusCount,
+                                         [&](const char* statusName) { return status == statusName; });
+                if (name == statusNames + ResultStatusCount)
+                    return -1;
+                record.status = static_cast<ResultStatus>(name - statusNames);
+
+                // No moves are written as "-".
+                path.clear();
+                if (letters != "-")
+                {
+                    for (auto letter : letters)
+                    {
+                        uint8_t move = 0;
+                        while (move < 4 && GetMoveLetter(static_cast<NPuzzleMove>(move)) != letter)
+                            move++;
+                        if (move == 4)
+                            return -1;
+                        path.push_back(static_cast<NPuzzleMove>(move));
+                    }
+                }
+                if (path.size() != record.length)
+                    return -1;
+
+                out.write(record, path);
+                count++;
+            }
+            return count;
+        }
+    }
+}
+
+#endif
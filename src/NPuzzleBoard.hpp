@@ -0,0 +1,140 @@
+/**
+ * \file NPuzzleBoard.hpp
+ * \brief A board whose width is chosen at runtime, for boards too large for NPuzzle::NPuzzleState.
+ */
+#ifndef __NPUZZLE_BOARD__
+#define __NPUZZLE_BOARD__
+
+namespace NPuzzle
+{
+    //! A move of the blank tile, the same as the operators of NPuzzle::NPuzzleProblem.
+    enum class NPuzzleMove : uint8_t { Left, Right, Up, Down };
+
+    //! Get the move undoing another one.
+    inline NPuzzleMove inverseMove(NPuzzleMove move)
+    {
+        return static_cast<NPuzzleMove>(static_cast<uint8_t>(move) ^ 1);
+    }
+
+    //! Get the name of a move.
+    inline const char* getMoveName(NPuzzleMove move)
+    {
+        static const char* names[] = { "left", "right", "up", "down" };
+        return names[static_cast<uint8_t>(move)];
+    }
+
+    /**
+     * \brief A \c width x \c width board stored in a \c std::vector.
+     *
+     * Tiles are numbered 1 to <tt>width * width - 1</tt>, and 0 is the blank.
+     */
+    class NPuzzleBoard
+    {
+    private:
+        int width;
+        std::vector<int> cells;
+        int blank;
+
+    public:
+        /**
+         * \param width The number of rows and columns.
+         * \param cells The tiles in row-major order.
+         */
+        NPuzzleBoard(int width, std::vector<int> cells) : width(width), cells(std::move(cells))
+        {
+            blank = static_cast<int>(std::find(this->cells.begin(), this->cells.end(), 0) - this->cells.begin());
+        }
+
+        //! The goal used by default, <tt>1, 2, ..., N, 0</tt>.
+        static NPuzzleBoard DefaultGoal(int width)
+        {
+            std::vector<int> cells(width * width);
+            for (int i = 0; i + 1 < width * width; i++)
+                cells[i] = i + 1;
+            cells.back() = 0;
+            return NPuzzleBoard(width, std::move(cells));
+        }
+
+        //! Get the number of rows and columns.
+        int getWidth() const { return width; }
+        //! Get the number of cells.
+        int size() const { return static_cast<int>(cells.size()); }
+        //! Get the tile in a cell.
+        int at(int index) const { return cells[index]; }
+        //! Get all tiles in row-major order.
+        const std::vector<int>& getCells() const { return cells; }
+        //! Get the cell of the blank.
+        int getBlank() const { return blank; }
+
+        //! Get the cell the blank moves to, -1 if it would leave the board.
+        int getTarget(NPuzzleMove move) const { return getTarget(blank, move); }
+
+        //! Get the cell next to \c index in a direction, -1 if it would leave the board.
+        int getTarget(int index, NPuzzleMove move) const
+        {
+            int row = index / width, col = index % width;
+            switch (move)
+            {
+            case NPuzzleMove::Left:  return col > 0 ? index - 1 : -1;
+            case NPuzzleMove::Right: return col + 1 < width ? index + 1 : -1;
+            case NPuzzleMove::Up:    return row > 0 ? index - width : -1;
+            default:                 return row + 1 < width ? index + width : -1;
+            }
+        }
+
+        //! Move the blank, which should stay on the board.
+        void move(NPuzzleMove move)
+        {
+            int target = getTarget(move);
+            std::swap(cells[blank], cells[target]);
+            blank = target;
+        }
+
+        //! Whether each of <tt>0, 1, ..., width * width - 1</tt> appears exactly once.
+        bool isPermutation() const
+        {
+            std::vector<bool> seen(cells.size(), false);
+            for (auto tile : cells)
+            {
+                if (tile < 0 || tile >= size() || seen[tile])
+                    return false;
+                seen[tile] = true;
+            }
+            return true;
+        }
+
+        /**
+         * \brief Whether the board could reach a goal, checked in O(N) like NPuzzle::isSolvable.
+         * \param goal The goal board of the same width.
+         */
+        bool isSolvable(const NPuzzleBoard& goal) const
+        {
+            if (goal.width != width || !isPermutation() || !goal.isPermutation())
+                return false;
+
+            std::vector<int> position(cells.size());
+            for (int i = 0; i < size(); i++)
+                position[goal.cells[i]] = i;
+
+            // Parity of the permutation by cycle decomposition.
+            std::vector<bool> visited(cells.size(), false);
+            int transpositions = 0;
+            for (int i = 0; i < size(); i++)
+            {
+                if (visited[i])
+                    continue;
+                for (int j = i; !visited[j]; j = position[cells[j]])
+                {
+                    visited[j] = true;
+                    transpositions++;
+                }
+                transpositions--;
+            }
+
+            int blankDistance = abs(blank / width - goal.blank / width) + abs(blank % width - goal.blank % width);
+            return transpositions % 2 == blankDistance % 2;
+        }
+    };
+}
+
+#endif
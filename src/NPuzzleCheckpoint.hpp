@@ -0,0 +1,380 @@
+/**
+ * \file NPuzzleCheckpoint.hpp
+ * \brief Binary snapshots of a search, used to resume it later.
+ *
+ * A checkpoint at \c path consists of two files:
+ * - \c path holds a NPuzzle::Checkpoint::Header and the whole search queue.
+ *   It is rewritten on each checkpoint, by writing a temporary file and renaming it.
+ * - <tt>path.journal</tt> holds the mappings from children to parents, one
+ *   NPuzzle::Checkpoint::MappingRecord each. Since mappings are never removed
+ *   during a search, only new ones are appended on each checkpoint.
+ *
+ * Visited states are not stored, since they are exactly the initial state and
+ * the children in the journal. Records are in the native layout of the build,
+ * so the journal could be mapped into memory directly when resuming.
+ */
+#ifndef __NPUZZLE_CHECKPOINT__
+#define __NPUZZLE_CHECKPOINT__
+
+#if defined(__unix__) || defined(__APPLE__)
+#define NPUZZLE_CHECKPOINT_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace NPuzzle
+{
+    //! The binary layout of checkpoints.
+    namespace Checkpoint
+    {
+        static_assert(demonstration < 255, "Tiles are stored in bytes.");
+
+        //! Identifies a checkpoint file, and its layout version.
+        constexpr char Magic[8] = { 'N', 'P', 'Z', 'C', 'K', 'P', 'T', '2' };
+
+        //! Identifies the heuristic function of a search, since \c h(n) of queued nodes is stored.
+        enum class HeuristicId : uint32_t
+        {
+            //! A function other than the ones below, which could not be told apart.
+            Custom,
+            Uniform,
+            MisplacedTileCount,
+            ManhattanDistance,
+            LinearConflictDistance
+        };
+
+        //! Identify a heuristic function.
+        inline HeuristicId GetHeuristicId(const NPuzzleCostFunction& hFunc)
+        {
+            typedef int (*CostFunctionPtrT)(NPuzzleNode);
+
+            auto func = hFunc.target<CostFunctionPtrT>();
+            if (!func)
+                return HeuristicId::Custom;
+            if (*func == GetUniformHeuristicCost)
+                return HeuristicId::Uniform;
+            if (*func == GetMisplacedTileCount)
+                return HeuristicId::MisplacedTileCount;
+            if (*func == GetManhattanDistance)
+                return HeuristicId::ManhattanDistance;
+            if (*func == GetLinearConflictDistance)
+                return HeuristicId::LinearConflictDistance;
+            return HeuristicId::Custom;
+        }
+
+        //! A node, with tiles (in canonical labels) stored in bytes.
+        struct NodeRecord
+        {
+            uint8_t state[demonstration + 1];
+            int32_t depth;
+            int32_t heuristic;
+            int32_t costOffset;
+
+            static NodeRecord FromNode(const NPuzzleNode& node)
+            {
+                auto record = NodeRecord();
+                auto state = node.getState();
+                for (int i = 0; i <= demonstration; i++)
+                    record.state[i] = static_cast<uint8_t>(state[i]);
+                record.depth = node.getDepth();
+                record.heuristic = node.getHeuristic();
+                record.costOffset = node.getCostOffset();
+                return record;
+            }
+
+            NPuzzleNode toNode() const
+            {
+                NPuzzleState result;
+                for (int i = 0; i <= demonstration; i++)
+                    result[i] = state[i];
+                NPuzzleNode node(result, depth, heuristic);
+                node.setCostOffset(costOffset);
+                return node;
+            }
+        };
+
+        //! A mapping from a child node to its parent node.
+        struct MappingRecord
+        {
+            NodeRecord child;
+            NodeRecord parent;
+        };
+
+        //! The header of a checkpoint.
+        struct Header
+        {
+            char magic[8];
+            //! NPuzzle::demonstration of the build which wrote it.
+            uint32_t puzzleSize;
+            uint32_t nodeRecordSize;
+            //! The Checkpoint::HeuristicId of the heuristic function.
+            uint32_t heuristic;
+            //! Whether partial expansion is enabled, 0 or 1.
+            uint32_t partialExpansion;
+            //! The radius of the perimeter used, -1 if none.
+            int32_t perimeterRadius;
+            uint64_t batchSize;
+            uint64_t totalNodesExpanded;
+            uint64_t maxQueueLength;
+            //! The number of records in the journal belonging to this checkpoint.
+            uint64_t journalRecords;
+            uint64_t queueSize;
+            //! The initial state in original labels.
+            uint8_t initialState[demonstration + 1];
+            //! The goal state in original labels.
+            uint8_t finalState[demonstration + 1];
+
+            //! Whether the checkpoint was written by a build with the same layout.
+            bool isCompatible() const
+            {
+                return std::equal(magic, magic + sizeof(magic), Magic) &&
+                       puzzleSize == static_cast<uint32_t>(demonstration) &&
+                       nodeRecordSize == sizeof(NodeRecord);
+            }
+        };
+
+        //! Get the path of the journal of a checkpoint.
+        inline std::string GetJournalPath(const std::string& path) { return path + ".journal"; }
+
+        //! Pack a state into bytes.
+        inline void PackState(const NPuzzleState& state, uint8_t* out)
+        {
+            for (int i = 0; i <= demonstration; i++)
+                out[i] = static_cast<uint8_t>(state[i]);
+        }
+
+        //! Unpack a state from bytes.
+        inline NPuzzleState UnpackState(const uint8_t* packed)
+        {
+            NPuzzleState state;
+            for (int i = 0; i <= demonstration; i++)
+                state[i] = packed[i];
+            return state;
+        }
+    }
+
+    /**
+     * \brief Writes checkpoints in a background thread.
+     *
+     * The caller only copies the queue and hands over new journal records, then
+     * goes on searching while the files are written. Writing the next checkpoint
+     * waits for the previous one.
+     */
+    class NPuzzleCheckpointWriter
+    {
+    private:
+        std::string path;
+        std::thread worker;
+        // Set by the worker, read after joining it.
+        std::string error;
+
+    public:
+        NPuzzleCheckpointWriter() {}
+        NPuzzleCheckpointWriter(const NPuzzleCheckpointWriter&) = delete;
+        NPuzzleCheckpointWriter& operator=(const NPuzzleCheckpointWriter&) = delete;
+        ~NPuzzleCheckpointWriter() { wait(); }
+
+        /**
+         * \brief Start writing checkpoints to a path.
+         * \param path The path of the checkpoint.
+         * \param journalRecords The number of journal records to keep, 0 for a new search.
+         *
+         * Records after \c journalRecords were written after the last complete
+         * checkpoint, so they are dropped.
+         */
+        void start(const std::string& path, uint64_t journalRecords)
+        {
+            wait();
+            this->path = path;
+            error.clear();
+
+            auto journalPath = Checkpoint::GetJournalPath(path);
+            auto bytes = journalRecords * sizeof(Checkpoint::MappingRecord);
+            if (bytes == 0)
+            {
+                // A checkpoint of another search should not be resumed with a new journal.
+                std::remove(path.c_str());
+                std::ofstream journal(journalPath, std::ios::binary | std::ios::trunc);
+                if (!journal)
+                    error = "Cannot create " + journalPath;
+                return;
+            }
+#ifdef NPUZZLE_CHECKPOINT_POSIX
+            if (truncate(journalPath.c_str(), static_cast<off_t>(bytes)) != 0)
+                error = "Cannot truncate " + journalPath;
+#else
+            std::vector<char> kept(bytes);
+            std::ifstream in(journalPath, std::ios::binary);
+            in.read(kept.data(), kept.size());
+            in.close();
+            std::ofstream out(journalPath, std::ios::binary | std::ios::trunc);
+            out.write(kept.data(), kept.size());
+            if (!out)
+                error = "Cannot truncate " + journalPath;
+#endif
+        }
+
+        /**
+         * \brief Write a checkpoint in the background.
+         * \param header The header, whose \c queueSize should match \c queue.
+         * \param queue The queue, in the order of the heap.
+         * \param journal Journal records since the previous checkpoint.
+         */
+        void write(const Checkpoint::Header& header, std::vector<Checkpoint::NodeRecord> queue,
+                   std::vector<Checkpoint::MappingRecord> journal)
+        {
+            wait();
+            worker = std::thread(&NPuzzleCheckpointWriter::writeFiles, this,
+                                 header, std::move(queue), std::move(journal));
+        }
+
+        //! Wait for the checkpoint being written.
+        void wait()
+        {
+            if (worker.joinable())
+                worker.join();
+        }
+
+        //! Get the error of writing checkpoints, empty if none.
+        std::string getError()
+        {
+            wait();
+            return error;
+        }
+
+    private:
+        void writeFiles(Checkpoint::Header header, std::vector<Checkpoint::NodeRecord> queue,
+                        std::vector<Checkpoint::MappingRecord> journal)
+        {
+            if (!error.empty())
+                return;
+
+            // The journal goes first, so a header never counts records not written yet.
+            auto journalPath = Checkpoint::GetJournalPath(path);
+            std::ofstream journalFile(journalPath, std::ios::binary | std::ios::app);
+            journalFile.write(reinterpret_cast<const char*>(journal.data()),
+                              journal.size() * sizeof(Checkpoint::MappingRecord));
+            journalFile.close();
+            if (!journalFile)
+            {
+                error = "Cannot write " + journalPath;
+                return;
+            }
+
+            auto temporaryPath = path + ".tmp";
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(queue.data()),
+                       queue.size() * sizeof(Checkpoint::NodeRecord));
+            file.close();
+            if (!file || std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+                error = "Cannot write " + path;
+        }
+    };
+
+    /**
+     * \brief Reads a checkpoint written by NPuzzle::NPuzzleCheckpointWriter.
+     *
+     * The journal is mapped into memory where possible rather than copied.
+     */
+    class NPuzzleCheckpointReader
+    {
+    private:
+        Checkpoint::Header header;
+        std::vector<Checkpoint::NodeRecord> queue;
+
+        // The journal, either mapped or read into the buffer.
+        const Checkpoint::MappingRecord* journal = nullptr;
+        std::vector<Checkpoint::MappingRecord> journalBuffer;
+        void* mapping = nullptr;
+        std::size_t mappingSize = 0;
+
+        std::string error;
+
+    public:
+        /**
+         * \param path The path of the checkpoint.
+         */
+        explicit NPuzzleCheckpointReader(const std::string& path)
+        {
+            std::ifstream file(path, std::ios::binary);
+            if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || !header.isCompatible())
+            {
+                error = "Not a compatible checkpoint: " + path;
+                return;
+            }
+
+            queue.resize(header.queueSize);
+            if (!file.read(reinterpret_cast<char*>(queue.data()),
+                           queue.size() * sizeof(Checkpoint::NodeRecord)))
+            {
+                error = "Truncated checkpoint: " + path;
+                return;
+            }
+
+            if (!openJournal(Checkpoint::GetJournalPath(path)))
+                error = "Truncated journal: " + Checkpoint::GetJournalPath(path);
+        }
+
+        NPuzzleCheckpointReader(const NPuzzleCheckpointReader&) = delete;
+        NPuzzleCheckpointReader& operator=(const NPuzzleCheckpointReader&) = delete;
+
+        ~NPuzzleCheckpointReader()
+        {
+#ifdef NPUZZLE_CHECKPOINT_POSIX
+            if (mapping)
+                munmap(mapping, mappingSize);
+#endif
+        }
+
+        //! Get the error of reading the checkpoint, empty if none.
+        std::string getError() const { return error; }
+        //! Get the header.
+        const Checkpoint::Header& getHeader() const { return header; }
+        //! Get the queue, in the order of the heap.
+        const std::vector<Checkpoint::NodeRecord>& getQueue() const { return queue; }
+        //! Get the journal records, there are <tt>getHeader().journalRecords</tt> of them.
+        const Checkpoint::MappingRecord* getJournal() const { return journal; }
+
+    private:
+        bool openJournal(const std::string& journalPath)
+        {
+            auto bytes = header.journalRecords * sizeof(Checkpoint::MappingRecord);
+            if (bytes == 0)
+                return true;
+
+#ifdef NPUZZLE_CHECKPOINT_POSIX
+            int fd = open(journalPath.c_str(), O_RDONLY);
+            if (fd < 0)
+                return false;
+
+            struct stat status;
+            if (fstat(fd, &status) == 0 && static_cast<uint64_t>(status.st_size) >= bytes)
+            {
+                mapping = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapping == MAP_FAILED)
+                    mapping = nullptr;
+            }
+            close(fd);
+
+            if (mapping)
+            {
+                mappingSize = bytes;
+                journal = static_cast<const Checkpoint::MappingRecord*>(mapping);
+                return true;
+            }
+#endif
+            // Fallback to reading the journal into memory.
+            journalBuffer.resize(header.journalRecords);
+            std::ifstream file(journalPath, std::ios::binary);
+            if (!file.read(reinterpret_cast<char*>(journalBuffer.data()), bytes))
+                return false;
+            journal = journalBuffer.data();
+            return true;
+        }
+    };
+}
+
+#endif
@@ -24,18 +24,22 @@ namespace NPuzzle
     private:
         NPuzzleState state;
         int depth;
+        int heuristic;
+        int costOffset = 0;
 
     public:
-        NPuzzleNode() : depth(FailureDepth) {}
+        NPuzzleNode() : depth(FailureDepth), heuristic(0) {}
 
         /**
          * \param state The state to be stored in node.
          * \param depth The depth to be stored in node.
+         * \param heuristic The heuristic cost \c h(n) to be stored in node.
          */
-        NPuzzleNode(NPuzzleState state, int depth) : state(state), depth(depth) {};
+        NPuzzleNode(NPuzzleState state, int depth, int heuristic = 0)
+            : state(state), depth(depth), heuristic(heuristic) {};
 
-        //! Get the state stored in node.
-        NPuzzleState getState() const { return state; }
+        //! Get the state stored in node, without copying it.
+        const NPuzzleState& getState() const { return state; }
         //! Set the state stored in node.
         void setState(NPuzzleState state) { this->state = state; }
 
@@ -43,17 +47,36 @@ namespace NPuzzle
         int getDepth() const { return depth; }
         //! Set the expanded depth of this node.
         void setDepth(int depth) { this->depth = depth; }
+
+        //! Get the heuristic cost \c h(n) evaluated when this node was made.
+        int getHeuristic() const { return heuristic; }
+        //! Set the heuristic cost \c h(n) of this node.
+        void setHeuristic(int heuristic) { this->heuristic = heuristic; }
+
+        /**
+         * \brief Get how much \c f(n) of this node is raised above \c g(n) + \c h(n).
+         *
+         * Enhanced Partial Expansion A* raises it when the node is enqueued again,
+         * so it is expanded again only for children with a larger \c f(n). It is 0 otherwise.
+         */
+        int getCostOffset() const { return costOffset; }
+        //! Set how much \c f(n) of this node is raised above \c g(n) + \c h(n).
+        void setCostOffset(int costOffset) { this->costOffset = costOffset; }
     };
 
     /**
      * \brief The N-Puzzle searcher, with NPuzzle::NPuzzleState as \c StateT,
      * NPuzzle::NPuzzleNode as \c NodeT and \c int as \c ExpandCostT.
+     *
+     * Its queue could allocate from an Arena, see ArenaAllocator.
      * \see GeneralSearcher
      */
-    typedef GeneralSearcher<NPuzzleState, NPuzzleNode, int> NPuzzleSearcher;
+    typedef GeneralSearcher<NPuzzleState, NPuzzleNode, int,
+                            ArenaAllocator<NPuzzleNode>>    NPuzzleSearcher;
     typedef NPuzzleSearcher::SearchResultT                  NPuzzleSearchResult;
     typedef NPuzzleSearcher::QueueT                         NPuzzleQueue;
     typedef NPuzzleSearcher::ExpandResultT                  NPuzzleExpandResult;
+    typedef NPuzzleSearcher::ExpandBatchResultT             NPuzzleExpandBatchResult;
     typedef NPuzzleSearcher::OperationResultT               NPuzzleOperationResult;
     /**
      * \brief The cost function type for \c g(n) and \c h(n).
@@ -0,0 +1,266 @@
+/**
+ * \file NPuzzleFringeSolver.hpp
+ * \brief The solver for N-Puzzle problem based on Fringe Search.
+ *
+ * Fringe Search visits nodes in the order of IDA* iterations, but keeps the
+ * frontier between iterations, so nothing is expanded twice. There is no priority
+ * queue: the frontier is two doubly-linked lists threaded through a flat node cache.
+ */
+#ifndef __NPUZZLE_FRINGE_SOLVER__
+#define __NPUZZLE_FRINGE_SOLVER__
+
+namespace NPuzzle
+{
+    /**
+     * \brief The solver for N-Puzzle problem based on Fringe Search.
+     *
+     * Each iteration walks the \e now list from its head. A node whose \c f(n)
+     * exceeds the threshold is moved to the \e later list. Otherwise it is
+     * expanded, and its children are linked right after it, so they are visited
+     * in the same iteration, depth-first. When \e now runs out, \e later becomes
+     * \e now and the threshold rises to the least \c f(n) seen in it.
+     *
+     * Every state ever generated keeps a slot in the cache, holding its \c g(n),
+     * \c h(n) and the slot of its parent, so \c h(n) is evaluated once per state.
+     * With an admissible \c h(n), the solution is optimal.
+     */
+    class NPuzzleFringeSolver
+    {
+    private:
+        static constexpr int NoSlot = -1;
+        static constexpr int NoList = -1;
+
+        // A slot of the node cache, linked into a list by slot indices.
+        struct Slot
+        {
+            NPuzzleState state;
+            int depth;
+            int heuristic;
+            int parent;
+            int prev = NoSlot;
+            int next = NoSlot;
+            // The list it is linked into, NoList if expanded.
+            int list = NoList;
+
+            Slot(const NPuzzleState& state, int depth, int heuristic, int parent)
+                : state(state), depth(depth), heuristic(heuristic), parent(parent) {}
+        };
+
+        // A doubly-linked list of slots.
+        struct List
+        {
+            int head = NoSlot;
+            int tail = NoSlot;
+            std::size_t size = 0;
+        };
+
+        // Lists are swapped by their indices, so slots need not be updated.
+        static constexpr int Now = 0;
+        static constexpr int Later = 1;
+
+        // Parameters
+        NPuzzleCostFunction hFunc;
+
+        // Statistic
+        unsigned long totalNodesExpanded = 0;
+        unsigned long maxQueueLength = 0;
+        unsigned long iterations = 0;
+
+        // The node cache, and the slots of states.
+        std::vector<Slot> slots;
+        std::unordered_map<NPuzzleState, int> slotOfState;
+        List lists[2];
+        int now = Now, later = Later;
+
+        // Last search
+        NPuzzleGoal goal;
+        int finalSlot = NoSlot;
+
+    public:
+        //! Get the total amount of nodes expanded.
+        unsigned long getTotalNodesExpanded() const { return totalNodesExpanded; }
+        //! Get the max length of the fringe, both lists together.
+        unsigned long getMaxQueueLength() const { return maxQueueLength; }
+        //! Get the number of thresholds tried by last search.
+        unsigned long getIterations() const { return iterations; }
+
+        //! Get the heuristic function (\c h(n)).
+        NPuzzleCostFunction getHeuristicFunction() const { return hFunc; }
+        //! Set the heuristic function (\c h(n)), which should be admissible.
+        void setHeuristicFunction(NPuzzleCostFunction hFunc) { this->hFunc = hFunc; }
+
+        /**
+         * \brief Solve the N-Puzzle problem.
+         * \param initialState The intital state.
+         * \param finalState The goal state.
+         * \return The search result.
+         */
+        NPuzzleSearchResult solve(NPuzzleState initialState, NPuzzleState finalState)
+        {
+            // Clear the information last search left, keeping the memory.
+            slots.clear();
+            slotOfState.clear();
+            lists[Now] = lists[Later] = List();
+            now = Now;
+            later = Later;
+            finalSlot = NoSlot;
+            totalNodesExpanded = 0;
+            maxQueueLength = 0;
+            iterations = 0;
+
+            goal = NPuzzleGoal(finalState);
+            if (!goal.isSolvable(initialState))
+                return NPuzzleSearchResult::Rejected();
+            initialState = goal.relabel(initialState);
+            auto canonicalGoal = goal.getCanonicalGoal();
+
+            NPuzzleProblem problem(initialState, canonicalGoal);
+            auto operators = problem.getOperators();
+
+            int threshold = hFunc(NPuzzleNode(initialState, 0));
+            slots.push_back(Slot(initialState, 0, threshold, NoSlot));
+            slotOfState[initialState] = 0;
+            pushBack(now, 0);
+            maxQueueLength = 1;
+
+            while (lists[now].size)
+            {
+                iterations++;
+                int nextThreshold = std::numeric_limits<int>::max();
+
+                for (int current = lists[now].head; current != NoSlot; )
+                {
+                    int f = slots[current].depth + slots[current].heuristic;
+                    if (f > threshold)
+                    {
+                        nextThreshold = std::min(nextThreshold, f);
+                        int next = slots[current].next;
+                        unlink(now, current);
+                        pushBack(later, current);
+                        current = next;
+                        continue;
+                    }
+
+                    if (slots[current].state == canonicalGoal)
+                    {
+                        finalSlot = current;
+                        return NPuzzleSearchResult::Success(goal.restore(
+                            NPuzzleNode(canonicalGoal, slots[current].depth)));
+                    }
+
+                    expand(current, operators);
+                    int next = slots[current].next;
+                    unlink(now, current);
+                    current = next;
+
+                    auto length = lists[now].size + lists[later].size;
+                    if (length > maxQueueLength)
+                        maxQueueLength = length;
+                }
+
+                threshold = nextThreshold;
+                std::swap(now, later);
+            }
+
+            return NPuzzleSearchResult::Failure();
+        }
+
+        /**
+         * \brief Get the path to the solution if exists.
+         * \return The path, starting with the initial state and excluding the final state.
+         */
+        std::vector<NPuzzleNode> getSolutionPath() const
+        {
+            std::vector<NPuzzleNode> path;
+            if (finalSlot == NoSlot)
+                return path;
+
+            for (int slot = slots[finalSlot].parent; slot != NoSlot; slot = slots[slot].parent)
+                path.push_back(goal.restore(NPuzzleNode(slots[slot].state, slots[slot].depth)));
+
+            // The path now is in reverse order, so we reverse it back.
+            std::reverse(path.begin(), path.end());
+            return path;
+        }
+
+    private:
+        // Link the children of a slot right after it, in the now list.
+        void expand(int current, const std::vector<NPuzzleProblem::OperatorT>& operators)
+        {
+            // Copy the state, since new slots may reallocate the cache.
+            auto state = slots[current].state;
+            int position = current;
+
+            for (auto& action : operators)
+            {
+                auto res = action(state);
+                if (!res.isSucceeded())
+                    continue;
+
+                auto nextState = res.getState();
+                int depth = slots[current].depth + res.getCost();
+                auto inserted = slotOfState.insert(std::make_pair(nextState, static_cast<int>(slots.size())));
+                int child = inserted.first->second;
+                if (inserted.second)
+                    slots.push_back(Slot(nextState, depth, hFunc(NPuzzleNode(nextState, depth)), current));
+                else
+                {
+                    // Reached again, but no shorter.
+                    if (depth >= slots[child].depth)
+                        continue;
+                    slots[child].depth = depth;
+                    slots[child].parent = current;
+                    if (slots[child].list != NoList)
+                        unlink(slots[child].list, child);
+                }
+
+                insertAfter(now, position, child);
+                position = child;
+                totalNodesExpanded++;
+            }
+        }
+
+        void pushBack(int list, int slot)
+        {
+            insertAfter(list, lists[list].tail, slot);
+        }
+
+        // Insert a slot after another one, or at the head if \c position is NoSlot.
+        void insertAfter(int listIndex, int position, int slot)
+        {
+            auto& list = lists[listIndex];
+            auto& node = slots[slot];
+            node.prev = position;
+            node.next = position == NoSlot ? list.head : slots[position].next;
+            if (node.prev == NoSlot)
+                list.head = slot;
+            else
+                slots[node.prev].next = slot;
+            if (node.next == NoSlot)
+                list.tail = slot;
+            else
+                slots[node.next].prev = slot;
+            node.list = listIndex;
+            list.size++;
+        }
+
+        void unlink(int listIndex, int slot)
+        {
+            auto& list = lists[listIndex];
+            auto& node = slots[slot];
+            if (node.prev == NoSlot)
+                list.head = node.next;
+            else
+                slots[node.prev].next = node.next;
+            if (node.next == NoSlot)
+                list.tail = node.prev;
+            else
+                slots[node.next].prev = node.prev;
+            node.prev = node.next = NoSlot;
+            node.list = NoList;
+            list.size--;
+        }
+    };
+}
+
+#endif
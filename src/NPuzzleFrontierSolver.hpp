@@ -0,0 +1,204 @@
+/**
+ * \file NPuzzleFrontierSolver.hpp
+ * \brief The memory-lean solver for N-Puzzle problem, based on divide-and-conquer
+ * Breadth-First Heuristic Search.
+ *
+ * No parent pointers are kept. The search stores only a few layers of the frontier,
+ * and each node in them remembers a single relay node from the middle of its path.
+ * The path is rebuilt by solving the two halves around the relay recursively.
+ */
+#ifndef __NPUZZLE_FRONTIER_SOLVER__
+#define __NPUZZLE_FRONTIER_SOLVER__
+
+namespace NPuzzle
+{
+    /**
+     * \brief The memory-lean solver for N-Puzzle problem.
+     *
+     * Breadth-First Heuristic Search expands layer by layer, pruning nodes whose
+     * \c f(n) exceeds an upper bound. Since every move is reversible, a child is
+     * either in the previous, the current or the next layer, so only these three
+     * layers are stored to detect duplicates.
+     *
+     * The bound starts from \c h(n) of the initial state and rises by 2, since the
+     * parity of every solution is fixed by where the blank goes. The first bound
+     * reaching the goal is the optimal depth. Nodes at half of that depth become
+     * relays of their descendants, so the goal knows which middle node it came
+     * through, and both halves are solved the same way with their exact depths.
+     */
+    class NPuzzleFrontierSolver
+    {
+    private:
+        // A layer maps states to their relays, in canonical labels of the subproblem.
+        typedef std::unordered_map<NPuzzleState, NPuzzleState> LayerT;
+
+        // Parameters
+        NPuzzleCostFunction hFunc;
+
+        // Statistic
+        unsigned long totalNodesExpanded = 0;
+        unsigned long maxStoredNodes = 0;
+        unsigned long searches = 0;
+
+        // Reused by every search.
+        LayerT previous, current, next;
+
+        // The path of last search, in original labels.
+        std::vector<NPuzzleState> path;
+
+    public:
+        //! Get the total amount of nodes expanded, in all searches of the halves.
+        unsigned long getTotalNodesExpanded() const { return totalNodesExpanded; }
+        //! Get the max number of nodes stored at any one time, in all three layers.
+        unsigned long getMaxStoredNodes() const { return maxStoredNodes; }
+        //! Get the number of breadth-first searches run, including the ones for halves.
+        unsigned long getSearches() const { return searches; }
+
+        //! Get the heuristic function (\c h(n)).
+        NPuzzleCostFunction getHeuristicFunction() const { return hFunc; }
+        //! Set the heuristic function (\c h(n)), which should be admissible and consistent.
+        void setHeuristicFunction(NPuzzleCostFunction hFunc) { this->hFunc = hFunc; }
+
+        /**
+         * \brief Solve the N-Puzzle problem.
+         * \param initialState The intital state.
+         * \param finalState The goal state.
+         * \return The search result.
+         */
+        NPuzzleSearchResult solve(NPuzzleState initialState, NPuzzleState finalState)
+        {
+            path.clear();
+            totalNodesExpanded = 0;
+            maxStoredNodes = 0;
+            searches = 0;
+
+            NPuzzleGoal goal(finalState);
+            if (!goal.isSolvable(initialState))
+                return NPuzzleSearchResult::Rejected();
+
+            // Every move moves the blank by one, so the depth has the parity of its distance.
+            int bound = hFunc(goal.relabel(NPuzzleNode(initialState, 0)));
+            if (bound % 2 != blankDistance(initialState, finalState) % 2)
+                bound++;
+
+            NPuzzleState relay;
+            while (!search(initialState, finalState, bound, relay))
+                bound += 2;
+
+            path.push_back(initialState);
+            rebuild(initialState, finalState, bound, relay);
+            return NPuzzleSearchResult::Success(NPuzzleNode(finalState, bound));
+        }
+
+        /**
+         * \brief Get the path to the solution if exists.
+         * \return The path, starting with the initial state and excluding the final state.
+         */
+        std::vector<NPuzzleNode> getSolutionPath() const
+        {
+            std::vector<NPuzzleNode> nodes;
+            for (std::size_t i = 0; i + 1 < path.size(); i++)
+                nodes.push_back(NPuzzleNode(path[i], static_cast<int>(i)));
+            return nodes;
+        }
+
+    private:
+        static int blankDistance(const NPuzzleState& a, const NPuzzleState& b)
+        {
+            int row, col, otherRow, otherCol;
+            indexToMatrix(std::find(a.begin(), a.end(), 0) - a.begin(), row, col);
+            indexToMatrix(std::find(b.begin(), b.end(), 0) - b.begin(), otherRow, otherCol);
+            return abs(row - otherRow) + abs(col - otherCol);
+        }
+
+        // Append the path after from, to the end of to, whose depth is known.
+        void rebuild(const NPuzzleState& from, const NPuzzleState& to, int depth, const NPuzzleState& relay)
+        {
+            if (depth <= 1)
+            {
+                if (depth == 1)
+                    path.push_back(to);
+                return;
+            }
+
+            int middle = depth / 2;
+            solveHalf(from, relay, middle);
+            solveHalf(relay, to, depth - middle);
+        }
+
+        void solveHalf(const NPuzzleState& from, const NPuzzleState& to, int depth)
+        {
+            NPuzzleState relay = from;
+            if (depth > 1)
+                search(from, to, depth, relay);
+            rebuild(from, to, depth, relay);
+        }
+
+        /**
+         * Breadth-first heuristic search within a bound, in original labels.
+         * On success, relay is set to the node at half of the bound on the path.
+         */
+        bool search(const NPuzzleState& from, const NPuzzleState& to, int bound, NPuzzleState& relay)
+        {
+            searches++;
+            NPuzzleGoal goal(to);
+            auto initialState = goal.relabel(from);
+            auto canonicalGoal = goal.getCanonicalGoal();
+            if (initialState == canonicalGoal)
+            {
+                relay = from;
+                return true;
+            }
+
+            NPuzzleProblem problem(initialState, canonicalGoal);
+            auto operators = problem.getOperators();
+            int middle = bound / 2;
+
+            previous.clear();
+            current.clear();
+            next.clear();
+            current[initialState] = initialState;
+
+            for (int depth = 0; depth < bound && !current.empty(); depth++)
+            {
+                for (auto& pair : current)
+                {
+                    for (auto& action : operators)
+                    {
+                        auto res = action(pair.first);
+                        if (!res.isSucceeded())
+                            continue;
+
+                        auto child = res.getState();
+                        int childDepth = depth + res.getCost();
+                        if (previous.count(child) || current.count(child) || next.count(child))
+                            continue;
+                        if (childDepth + hFunc(NPuzzleNode(child, childDepth)) > bound)
+                            continue;
+
+                        auto childRelay = childDepth == middle ? child : pair.second;
+                        if (child == canonicalGoal)
+                        {
+                            relay = goal.restore(childRelay);
+                            return true;
+                        }
+                        next[child] = childRelay;
+                        totalNodesExpanded++;
+                    }
+                }
+
+                unsigned long stored = previous.size() + current.size() + next.size();
+                if (stored > maxStoredNodes)
+                    maxStoredNodes = stored;
+
+                // Rotate the layers, keeping their buckets.
+                std::swap(previous, current);
+                std::swap(current, next);
+                next.clear();
+            }
+            return false;
+        }
+    };
+}
+
+#endif
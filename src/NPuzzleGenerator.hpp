@@ -0,0 +1,287 @@
+/**
+ * \file NPuzzleGenerator.hpp
+ * \brief The multi-threaded generator of random N-Puzzle instances.
+ *
+ * Each instance is drawn from its own random number generator, seeded by the seed
+ * of the generator and the index of the instance. So the output depends only on the
+ * seed, no matter how many threads generate it.
+ */
+#ifndef __NPUZZLE_GENERATOR__
+#define __NPUZZLE_GENERATOR__
+
+namespace NPuzzle
+{
+    /**
+     * \brief A small random number generator (SplitMix64), cheap to seed per instance.
+     *
+     * Random numbers are drawn by its own operators rather than by distributions of
+     * the standard library, whose results differ between implementations.
+     */
+    class NPuzzleRandom
+    {
+    private:
+        uint64_t state;
+
+    public:
+        typedef uint64_t result_type;
+
+        /**
+         * \param seed The seed of the generator.
+         * \param stream The index of the stream, such as the index of an instance.
+         */
+        NPuzzleRandom(uint64_t seed, uint64_t stream) : state(seed ^ (stream * 0xD1B54A32D192ED03ULL))
+        {
+            // Spread nearby streams apart.
+            (*this)();
+        }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<uint64_t>::max(); }
+
+        result_type operator()()
+        {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        //! Get a random number in <tt>[0, bound)</tt>.
+        uint64_t below(uint64_t bound) { return (*this)() % bound; }
+    };
+
+    /**
+     * \brief The multi-threaded generator of random N-Puzzle instances.
+     *
+     * Instances are generated in chunks by all threads, then handed to a sink
+     * in the order of their indices, so the output could be streamed into a file
+     * such as an NPuzzle::NPuzzleInstanceWriter without holding all of it.
+     */
+    class NPuzzleGenerator
+    {
+    public:
+        //! Receives instances in the order of their indices.
+        typedef std::function<void(uint64_t index, const NPuzzleState& state)> SinkT;
+        //! Receives instances bucketed by their optimal depth, in the order they are found.
+        typedef std::function<void(int depth, const NPuzzleState& state)> DepthSinkT;
+
+    private:
+        // Parameters
+        uint64_t seed;
+        unsigned threads;
+        std::size_t chunkSize = 65536;
+        NPuzzleState finalState;
+        NPuzzleCostFunction hFunc = GetManhattanDistance;
+
+        // Statistic
+        unsigned long candidates = 0;
+
+    public:
+        /**
+         * \param seed The seed, the same seed generates the same instances.
+         * \param threads The number of threads, 0 for the number of hardware threads.
+         */
+        explicit NPuzzleGenerator(uint64_t seed = 0, unsigned threads = 0)
+            : seed(seed), finalState(NPuzzleGoal::DefaultGoal())
+        {
+            setThreads(threads);
+        }
+
+        //! Get the seed.
+        uint64_t getSeed() const { return seed; }
+        //! Set the seed.
+        void setSeed(uint64_t seed) { this->seed = seed; }
+
+        //! Get the number of threads.
+        unsigned getThreads() const { return threads; }
+        //! Set the number of threads, 0 for the number of hardware threads.
+        void setThreads(unsigned threads)
+        {
+            this->threads = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        //! Get the number of instances generated by all threads before handing them to the sink.
+        std::size_t getChunkSize() const { return chunkSize; }
+        //! Set the number of instances generated by all threads before handing them to the sink.
+        void setChunkSize(std::size_t chunkSize) { this->chunkSize = std::max<std::size_t>(1, chunkSize); }
+
+        //! Get the goal state, which all instances could reach.
+        NPuzzleState getFinalState() const { return finalState; }
+        //! Set the goal state, which all instances could reach.
+        void setFinalState(NPuzzleState finalState) { this->finalState = finalState; }
+
+        //! Get the heuristic function of the optimal solver used by generateByDepth().
+        NPuzzleCostFunction getHeuristicFunction() const { return hFunc; }
+        //! Set the heuristic function of the optimal solver used by generateByDepth().
+        void setHeuristicFunction(NPuzzleCostFunction hFunc) { this->hFunc = hFunc; }
+
+        //! Get the number of instances solved by the last generateByDepth().
+        unsigned long getCandidates() const { return candidates; }
+
+        /**
+         * \brief Generate uniformly random instances which could reach the goal state.
+         * \param count The number of instances.
+         * \param sink Receives the instances.
+         *
+         * Permutations are drawn uniformly until NPuzzle::isSolvable passes.
+         */
+        void generateUniform(uint64_t count, SinkT sink) const
+        {
+            generate(count, sink, [this](uint64_t index) { return makeUniform(index); });
+        }
+
+        /**
+         * \brief Generate instances by random walks from the goal state.
+         * \param count The number of instances.
+         * \param moves The number of moves of each walk.
+         * \param sink Receives the instances.
+         *
+         * No move undoes the previous one, so each walk makes exactly \c moves moves,
+         * and the optimal depth of an instance is at most \c moves.
+         */
+        void generateWalk(uint64_t count, int moves, SinkT sink) const
+        {
+            generate(count, sink, [this, moves](uint64_t index) {
+                NPuzzleRandom rng(seed, index);
+                return makeWalk(rng, moves);
+            });
+        }
+
+        /**
+         * \brief Generate instances bucketed by their optimal depth.
+         * \param perDepth The number of instances wanted of each depth.
+         * \param minDepth The min depth wanted.
+         * \param maxDepth The max depth wanted.
+         * \param maxCandidates The max number of candidates solved, since deep instances could be rare.
+         * \param sink Receives the instances.
+         * \return The number of instances generated of each depth, from \c minDepth to \c maxDepth.
+         *
+         * Candidates are random walks of random lengths, solved optimally by an
+         * NPuzzle::NPuzzleFringeSolver in each thread. This is only practical for
+         * sizes whose instances it solves fast, such as the 8-puzzle.
+         */
+        std::vector<uint64_t> generateByDepth(uint64_t perDepth, int minDepth, int maxDepth,
+                                              uint64_t maxCandidates, DepthSinkT sink)
+        {
+            std::vector<uint64_t> counts(maxDepth - minDepth + 1, 0);
+            uint64_t missing = perDepth * counts.size();
+            candidates = 0;
+
+            std::vector<std::unique_ptr<NPuzzleFringeSolver>> solvers;
+            for (unsigned i = 0; i < threads; i++)
+            {
+                solvers.emplace_back(new NPuzzleFringeSolver());
+                solvers.back()->setHeuristicFunction(hFunc);
+            }
+
+            // Solving is far slower than generating, so chunks are smaller to stop soon after buckets are full.
+            std::size_t solveChunkSize = std::min<std::size_t>(chunkSize, 256 * threads);
+            std::vector<NPuzzleState> states;
+            std::vector<int> depths;
+            for (uint64_t first = 0; first < maxCandidates && missing > 0; first += solveChunkSize)
+            {
+                auto size = static_cast<std::size_t>(std::min<uint64_t>(solveChunkSize, maxCandidates - first));
+                states.resize(size);
+                depths.resize(size);
+                parallelFor(size, [&](std::size_t i, unsigned worker) {
+                    // Walks twice as long as the max depth reach deep instances as well.
+                    NPuzzleRandom rng(seed, first + i);
+                    int moves = minDepth + static_cast<int>(rng.below(2 * maxDepth - minDepth + 1));
+                    states[i] = makeWalk(rng, moves);
+                    depths[i] = solvers[worker]->solve(states[i], finalState).getFinalNode().getDepth();
+                });
+
+                // Buckets are filled in the order of indices, so the output depends only on the seed.
+                for (std::size_t i = 0; i < size && missing > 0; i++)
+                {
+                    candidates++;
+                    if (depths[i] < minDepth || depths[i] > maxDepth || counts[depths[i] - minDepth] == perDepth)
+                        continue;
+                    counts[depths[i] - minDepth]++;
+                    missing--;
+                    sink(depths[i], states[i]);
+                }
+            }
+            return counts;
+        }
+
+    private:
+        template <class MakeT>
+        void generate(uint64_t count, SinkT& sink, MakeT make) const
+        {
+            std::vector<NPuzzleState> states;
+            for (uint64_t first = 0; first < count; first += chunkSize)
+            {
+                auto size = static_cast<std::size_t>(std::min<uint64_t>(chunkSize, count - first));
+                states.resize(size);
+                parallelFor(size, [&](std::size_t i, unsigned) { states[i] = make(first + i); });
+                for (std::size_t i = 0; i < size; i++)
+                    sink(first + i, states[i]);
+            }
+        }
+
+        // Run func(i, worker) for i in [0, size), each worker takes every threads-th index.
+        template <class FuncT>
+        void parallelFor(std::size_t size, FuncT func) const
+        {
+            unsigned workers = static_cast<unsigned>(std::min<std::size_t>(threads, size));
+            std::vector<std::thread> pool;
+            for (unsigned worker = 1; worker < workers; worker++)
+            {
+                pool.emplace_back([&, worker] {
+                    for (std::size_t i = worker; i < size; i += workers)
+                        func(i, worker);
+                });
+            }
+            for (std::size_t i = 0; i < size; i += std::max(1u, workers))
+                func(i, 0);
+            for (auto& thread : pool)
+                thread.join();
+        }
+
+        NPuzzleState makeUniform(uint64_t index) const
+        {
+            // A different stream from the one of walks, in case both are generated with a seed.
+            NPuzzleRandom rng(~seed, index);
+            NPuzzleState state = finalState;
+            do
+            {
+                // Fisher-Yates shuffle.
+                for (int i = demonstration; i > 0; i--)
+                    std::swap(state[i], state[rng.below(i + 1)]);
+            } while (!isSolvable(state, finalState));
+            return state;
+        }
+
+        NPuzzleState makeWalk(NPuzzleRandom& rng, int moves) const
+        {
+            // Moves the blank directly, rather than through the operators of NPuzzle::NPuzzleProblem.
+            NPuzzleState state = finalState;
+            long blank = std::find(state.begin(), state.end(), 0) - state.begin(), previous = -1;
+            long choices[4];
+            for (int move = 0; move < moves; move++)
+            {
+                int row, col, count = 0;
+                indexToMatrix(blank, row, col);
+                if (col > 0)
+                    choices[count++] = blank - 1;
+                if (col + 1 < matrixDemonstration)
+                    choices[count++] = blank + 1;
+                if (row > 0)
+                    choices[count++] = blank - matrixDemonstration;
+                if (row + 1 < matrixDemonstration)
+                    choices[count++] = blank + matrixDemonstration;
+
+                // Going back to the previous cell would undo the previous move.
+                count = static_cast<int>(std::remove(choices, choices + count, previous) - choices);
+                long target = choices[rng.below(count)];
+                std::swap(state[blank], state[target]);
+                previous = blank;
+                blank = target;
+            }
+            return state;
+        }
+    };
+}
+
+#endif
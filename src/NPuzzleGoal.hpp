@@ -0,0 +1,122 @@
+/**
+ * \file NPuzzleGoal.hpp
+ * \brief Relabeling tiles so that any goal state maps onto the canonical one.
+ *
+ * The heuristic functions assume the goal is <tt>1, 2, ..., N</tt> with the blank
+ * last, that is tile \c t belongs to position <tt>t - 1</tt>. NPuzzle::NPuzzleGoal
+ * renames the tiles of a custom goal so that this assumption holds again.
+ */
+#ifndef __NPUZZLE_GOAL__
+#define __NPUZZLE_GOAL__
+
+namespace NPuzzle
+{
+    /**
+     * \brief Precomputed relabeling tables for a specific goal state.
+     *
+     * The tile at position \c i of the goal state is renamed to <tt>i + 1</tt>,
+     * and the blank stays 0. After relabeling, the canonical goal is
+     * <tt>1, ..., p, 0, p + 2, ..., N + 1</tt> where \c p is the goal position of
+     * the blank, so every tile \c t still belongs to position <tt>t - 1</tt>.
+     * Since heuristics ignore the blank, they apply unchanged to relabeled states.
+     */
+    class NPuzzleGoal
+    {
+    public:
+        //! Labels range over <tt>[0, demonstration + 1]</tt> after relabeling.
+        typedef std::array<int, demonstration + 2> LabelTableT;
+
+    private:
+        NPuzzleState goalState;
+        NPuzzleState canonicalGoal;
+        // Original tile -> canonical label.
+        LabelTableT toCanonical;
+        // Canonical label -> original tile.
+        LabelTableT fromCanonical;
+
+    public:
+        //! The goal used by default, <tt>1, 2, ..., N, 0</tt>.
+        static NPuzzleState DefaultGoal()
+        {
+            NPuzzleState state;
+            for (int i = 0; i < demonstration; i++)
+                state[i] = i + 1;
+            state[demonstration] = 0;
+            return state;
+        }
+
+    public:
+        NPuzzleGoal() : NPuzzleGoal(DefaultGoal()) {}
+
+        /**
+         * \param goalState The goal state, which should be a permutation of
+         * <tt>0, 1, ..., demonstration</tt>.
+         */
+        explicit NPuzzleGoal(NPuzzleState goalState) : goalState(goalState)
+        {
+            toCanonical.fill(0);
+            fromCanonical.fill(0);
+            canonicalGoal.fill(0);
+
+            // Tables of an invalid goal are left blank, see isSolvable().
+            if (!isPermutation(goalState))
+                return;
+
+            for (int i = 0; i <= demonstration; i++)
+            {
+                // Blank is always labeled as 0.
+                int label = goalState[i] ? i + 1 : 0;
+                canonicalGoal[i] = label;
+                toCanonical[goalState[i]] = label;
+                fromCanonical[label] = goalState[i];
+            }
+        }
+
+        //! Get the goal state in original labels.
+        NPuzzleState getGoalState() const { return goalState; }
+        //! Get the goal state in canonical labels.
+        NPuzzleState getCanonicalGoal() const { return canonicalGoal; }
+
+        /**
+         * \brief Whether a state could reach the goal state, checked in O(N).
+         * \param state The state in original labels.
+         * \return False if not, or if either state is not a permutation of tiles.
+         */
+        bool isSolvable(NPuzzleState state) const { return NPuzzle::isSolvable(state, goalState); }
+
+        //! Get the position where a tile (in original labels) belongs to.
+        int getTargetPosition(int tile) const { return toCanonical[tile] - 1; }
+
+        //! Rename the tiles of a state (in original labels) to canonical labels.
+        NPuzzleState relabel(NPuzzleState state) const
+        {
+            for (auto& tile : state)
+                tile = toCanonical[tile];
+            return state;
+        }
+
+        //! Rename the tiles of a state (in canonical labels) back to original labels.
+        NPuzzleState restore(NPuzzleState state) const
+        {
+            for (auto& tile : state)
+                tile = fromCanonical[tile];
+            return state;
+        }
+
+        //! Relabel the state stored in a node, keeping its depth.
+        NPuzzleNode relabel(NPuzzleNode node) const
+        {
+            node.setState(relabel(node.getState()));
+            return node;
+        }
+
+        //! Restore the state stored in a node, keeping its depth.
+        NPuzzleNode restore(NPuzzleNode node) const
+        {
+            node.setState(restore(node.getState()));
+            return node;
+        }
+    };
+}
+
+#endif
@@ -2,10 +2,11 @@
  * \file NPuzzleHeuristicFunction.hpp
  * \brief The heuristic functions \c h(n) for the N-Puzzle problem.
  *
- * Contains three heuristic functions:
+ * Contains four heuristic functions:
  * - NPuzzle::GetUniformHeuristicCost, for Uniform Cost Search.
  * - NPuzzle::GetMisplacedTileCount, for A* with Misplaced tiles.
  * - NPuzzle::GetManhattanDistance, for A* with Manhattan distance.
+ * - NPuzzle::GetLinearConflictDistance, for A* with Manhattan distance and linear conflicts.
  */
 #ifndef __NPUZZLE_HEURISTIC_FUNCTION__
 #define __NPUZZLE_HEURISTIC_FUNCTION__
@@ -51,6 +52,54 @@ namespace NPuzzle
         }
         return distance;
     };
+
+    /**
+     * \brief Calculate Manhattan distance plus linear conflicts, slower but more informed.
+     *
+     * Tiles in their target row (or column) but in reversed order block each other,
+     * so one of them has to leave the line and come back, costing 2 more moves.
+     * In each line, the fewest tiles to leave are those out of the longest
+     * increasing subsequence of target columns (or rows).
+     */
+    inline int GetLinearConflictDistance(NPuzzleNode node)
+    {
+        auto state = node.getState();
+        int distance = GetManhattanDistance(node);
+
+        std::vector<int> targets, tails;
+        for (int transposed = 0; transposed < 2; transposed++)
+        {
+            for (int line = 0; line < matrixDemonstration; line++)
+            {
+                // Targets along the line, of tiles belonging to the line.
+                targets.clear();
+                for (int i = 0; i < matrixDemonstration; i++)
+                {
+                    int index = transposed ? matrixToIndex(i, line) : matrixToIndex(line, i);
+                    if (state[index] == 0)
+                        continue;
+
+                    int targetRow, targetCol;
+                    indexToMatrix(state[index] - 1, targetRow, targetCol);
+                    if ((transposed ? targetCol : targetRow) == line)
+                        targets.push_back(transposed ? targetRow : targetCol);
+                }
+
+                // Longest increasing subsequence by patience sorting.
+                tails.clear();
+                for (auto target : targets)
+                {
+                    auto it = std::lower_bound(tails.begin(), tails.end(), target);
+                    if (it == tails.end())
+                        tails.push_back(target);
+                    else
+                        *it = target;
+                }
+                distance += 2 * static_cast<int>(targets.size() - tails.size());
+            }
+        }
+        return distance;
+    }
 }
 
 #endif
\ No newline at end of file
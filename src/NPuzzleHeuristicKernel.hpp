@@ -0,0 +1,343 @@
+/**
+ * \file NPuzzleHeuristicKernel.hpp
+ * \brief Vectorized kernels evaluating heuristics on byte-packed states.
+ *
+ * The kernels evaluate a full state at once rather than tile by tile, which
+ * serves cases like initial states and screening a batch of successors.
+ * There are SSSE3 and AVX2 versions with a scalar fallback, and the best one
+ * supported by the running CPU is chosen at runtime.
+ *
+ * Only boards with at most NPuzzle::PackedCells cells (up to the 15-puzzle)
+ * could be packed, larger boards always use the scalar functions.
+ */
+#ifndef __NPUZZLE_HEURISTIC_KERNEL__
+#define __NPUZZLE_HEURISTIC_KERNEL__
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NPUZZLE_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+namespace NPuzzle
+{
+    //! The number of cells in a packed state, one byte per cell.
+    constexpr int PackedCells = 16;
+    //! Whether NPuzzle::demonstration is small enough to be packed.
+    constexpr bool packable = demonstration + 1 <= PackedCells;
+
+    /**
+     * \brief A state packed into bytes, the unused cells are padded with 0.
+     *
+     * Packed states are expected to be in canonical labels, see NPuzzle::NPuzzleGoal.
+     */
+    typedef std::array<uint8_t, PackedCells> NPuzzlePackedState;
+
+    //! Pack a state into bytes.
+    inline NPuzzlePackedState packState(const NPuzzleState& state)
+    {
+        NPuzzlePackedState packed;
+        packed.fill(0);
+        for (int i = 0; i < std::min(demonstration + 1, PackedCells); i++)
+            packed[i] = static_cast<uint8_t>(state[i]);
+        return packed;
+    }
+
+    //! The kernels of a specific instruction set.
+    namespace HeuristicKernel
+    {
+        //! The type of a kernel evaluating \c count packed states into \c out.
+        typedef void (*BatchKernelT)(const NPuzzlePackedState* states, int* out, std::size_t count);
+
+        /**
+         * \brief Lookup tables shared by all kernels.
+         *
+         * Since tile \c t belongs to position <tt>t - 1</tt>, the row (column) of
+         * a position and the target row (column) of a tile share the same table.
+         */
+        struct Tables
+        {
+            alignas(16) uint8_t row[PackedCells];
+            alignas(16) uint8_t col[PackedCells];
+            alignas(16) uint8_t expected[PackedCells];
+
+            Tables()
+            {
+                for (int i = 0; i < PackedCells; i++)
+                {
+                    row[i] = static_cast<uint8_t>(i / matrixDemonstration);
+                    col[i] = static_cast<uint8_t>(i % matrixDemonstration);
+                    expected[i] = static_cast<uint8_t>(i + 1);
+                }
+            }
+        };
+
+        inline const Tables& GetTables()
+        {
+            static const Tables tables;
+            return tables;
+        }
+
+        //! Scalar misplaced tile count, the reference of other kernels.
+        inline int MisplacedTileCountScalar(const NPuzzlePackedState& state)
+        {
+            int count = 0;
+            for (int i = 0; i < PackedCells; i++)
+                if (state[i] > 0 && i + 1 != state[i]) // Not blank and misplaced
+                    count++;
+            return count;
+        }
+
+        //! Scalar Manhattan distance, the reference of other kernels.
+        inline int ManhattanDistanceScalar(const NPuzzlePackedState& state)
+        {
+            const auto& tables = GetTables();
+            int distance = 0;
+            for (int i = 0; i < PackedCells; i++)
+            {
+                if (state[i] > 0 && i + 1 != state[i]) // Not blank and misplaced
+                {
+                    distance += abs(tables.row[state[i] - 1] - tables.row[i]);
+                    distance += abs(tables.col[state[i] - 1] - tables.col[i]);
+                }
+            }
+            return distance;
+        }
+
+        inline void MisplacedTileCountScalarBatch(const NPuzzlePackedState* states, int* out, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; i++)
+                out[i] = MisplacedTileCountScalar(states[i]);
+        }
+
+        inline void ManhattanDistanceScalarBatch(const NPuzzlePackedState* states, int* out, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; i++)
+                out[i] = ManhattanDistanceScalar(states[i]);
+        }
+
+#ifdef NPUZZLE_KERNEL_X86
+        __attribute__((target("ssse3")))
+        inline int MisplacedTileCountSSE(const NPuzzlePackedState& state)
+        {
+            const auto& tables = GetTables();
+            __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state.data()));
+            __m128i expected = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.expected));
+
+            // Correct or blank cells are not counted.
+            __m128i skipped = _mm_or_si128(_mm_cmpeq_epi8(s, expected),
+                                           _mm_cmpeq_epi8(s, _mm_setzero_si128()));
+            return __builtin_popcount(~_mm_movemask_epi8(skipped) & 0xFFFF);
+        }
+
+        __attribute__((target("ssse3")))
+        inline int ManhattanDistanceSSE(const NPuzzlePackedState& state)
+        {
+            const auto& tables = GetTables();
+            __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state.data()));
+            __m128i row = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.row));
+            __m128i col = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.col));
+
+            // Target position is tile - 1, the blank becomes 0xFF and looks up 0.
+            __m128i target = _mm_sub_epi8(s, _mm_set1_epi8(1));
+            __m128i targetRow = _mm_shuffle_epi8(row, target);
+            __m128i targetCol = _mm_shuffle_epi8(col, target);
+
+            // |a - b| = max(a, b) - min(a, b) for unsigned bytes.
+            __m128i distance = _mm_add_epi8(
+                _mm_sub_epi8(_mm_max_epu8(targetRow, row), _mm_min_epu8(targetRow, row)),
+                _mm_sub_epi8(_mm_max_epu8(targetCol, col), _mm_min_epu8(targetCol, col)));
+            distance = _mm_andnot_si128(_mm_cmpeq_epi8(s, _mm_setzero_si128()), distance);
+
+            __m128i sum = _mm_sad_epu8(distance, _mm_setzero_si128());
+            return _mm_cvtsi128_si32(sum) + _mm_extract_epi16(sum, 4);
+        }
+
+        __attribute__((target("ssse3")))
+        inline void MisplacedTileCountSSEBatch(const NPuzzlePackedState* states, int* out, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; i++)
+                out[i] = MisplacedTileCountSSE(states[i]);
+        }
+
+        __attribute__((target("ssse3")))
+        inline void ManhattanDistanceSSEBatch(const NPuzzlePackedState* states, int* out, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; i++)
+                out[i] = ManhattanDistanceSSE(states[i]);
+        }
+
+        // AVX2 kernels evaluate two states at once, one in each 128-bit lane.
+        __attribute__((target("avx2")))
+        inline __m256i LoadTwo(const NPuzzlePackedState& a, const NPuzzlePackedState& b)
+        {
+            __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a.data()));
+            __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b.data()));
+            return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        }
+
+        __attribute__((target("avx2")))
+        inline __m256i BroadcastTable(const uint8_t* table)
+        {
+            return _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(table)));
+        }
+
+        __attribute__((target("avx2,popcnt")))
+        inline void MisplacedTileCountAVX2Batch(const NPuzzlePackedState* states, int* out, std::size_t count)
+        {
+            const auto& tables = GetTables();
+            __m256i expected = BroadcastTable(tables.expected);
+
+            std::size_t i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                __m256i s = LoadTwo(states[i], states[i + 1]);
+                __m256i skipped = _mm256_or_si256(_mm256_cmpeq_epi8(s, expected),
+                                                  _mm256_cmpeq_epi8(s, _mm256_setzero_si256()));
+                unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(skipped));
+                out[i] = __builtin_popcount(mask & 0xFFFF);
+                out[i + 1] = __builtin_popcount(mask >> 16);
+            }
+            if (i < count)
+                out[i] = MisplacedTileCountSSE(states[i]);
+        }
+
+        __attribute__((target("avx2")))
+        inline void ManhattanDistanceAVX2Batch(const NPuzzlePackedState* states, int* out, std::size_t count)
+        {
+            const auto& tables = GetTables();
+            __m256i row = BroadcastTable(tables.row);
+            __m256i col = BroadcastTable(tables.col);
+
+            std::size_t i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                __m256i s = LoadTwo(states[i], states[i + 1]);
+                __m256i target = _mm256_sub_epi8(s, _mm256_set1_epi8(1));
+                __m256i targetRow = _mm256_shuffle_epi8(row, target);
+                __m256i targetCol = _mm256_shuffle_epi8(col, target);
+
+                __m256i distance = _mm256_add_epi8(
+                    _mm256_sub_epi8(_mm256_max_epu8(targetRow, row), _mm256_min_epu8(targetRow, row)),
+                    _mm256_sub_epi8(_mm256_max_epu8(targetCol, col), _mm256_min_epu8(targetCol, col)));
+                distance = _mm256_andnot_si256(_mm256_cmpeq_epi8(s, _mm256_setzero_si256()), distance);
+
+                // Each 64-bit element holds the sum of 8 cells.
+                __m256i sum = _mm256_sad_epu8(distance, _mm256_setzero_si256());
+                out[i] = _mm256_extract_epi16(sum, 0) + _mm256_extract_epi16(sum, 4);
+                out[i + 1] = _mm256_extract_epi16(sum, 8) + _mm256_extract_epi16(sum, 12);
+            }
+            if (i < count)
+                out[i] = ManhattanDistanceSSE(states[i]);
+        }
+#endif
+
+        //! The instruction sets a kernel could be built on.
+        enum class InstructionSet { Scalar, SSE, AVX2 };
+
+        //! Detect the best instruction set supported by the running CPU.
+        inline InstructionSet DetectInstructionSet()
+        {
+#ifdef NPUZZLE_KERNEL_X86
+            __builtin_cpu_init();
+            // The AVX2 misplaced tile count kernel counts bits with POPCNT.
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+                return InstructionSet::AVX2;
+            if (__builtin_cpu_supports("ssse3"))
+                return InstructionSet::SSE;
+#endif
+            return InstructionSet::Scalar;
+        }
+
+        //! Get the name of an instruction set.
+        inline const char* GetInstructionSetName(InstructionSet set)
+        {
+            switch (set)
+            {
+            case InstructionSet::AVX2: return "AVX2";
+            case InstructionSet::SSE:  return "SSSE3";
+            default:                   return "Scalar";
+            }
+        }
+
+        //! Get the batch misplaced tile count kernel of an instruction set.
+        inline BatchKernelT GetMisplacedTileCountKernel(InstructionSet set)
+        {
+#ifdef NPUZZLE_KERNEL_X86
+            if (set == InstructionSet::AVX2) return MisplacedTileCountAVX2Batch;
+            if (set == InstructionSet::SSE)  return MisplacedTileCountSSEBatch;
+#endif
+            return MisplacedTileCountScalarBatch;
+        }
+
+        //! Get the batch Manhattan distance kernel of an instruction set.
+        inline BatchKernelT GetManhattanDistanceKernel(InstructionSet set)
+        {
+#ifdef NPUZZLE_KERNEL_X86
+            if (set == InstructionSet::AVX2) return ManhattanDistanceAVX2Batch;
+            if (set == InstructionSet::SSE)  return ManhattanDistanceSSEBatch;
+#endif
+            return ManhattanDistanceScalarBatch;
+        }
+
+        //! The kernels dispatched once for the running CPU.
+        struct Dispatch
+        {
+            InstructionSet set;
+            BatchKernelT misplacedTileCount;
+            BatchKernelT manhattanDistance;
+
+            Dispatch() : set(DetectInstructionSet()),
+                misplacedTileCount(GetMisplacedTileCountKernel(set)),
+                manhattanDistance(GetManhattanDistanceKernel(set)) {}
+        };
+
+        inline const Dispatch& GetDispatch()
+        {
+            static const Dispatch dispatch;
+            return dispatch;
+        }
+    }
+
+    /**
+     * \brief Calculate the count of misplaced tiles of \c count packed states.
+     * \param states The packed states.
+     * \param out The counts, should have room for \c count elements.
+     * \param count The number of states.
+     */
+    inline void GetMisplacedTileCountBatch(const NPuzzlePackedState* states, int* out, std::size_t count)
+    {
+        HeuristicKernel::GetDispatch().misplacedTileCount(states, out, count);
+    }
+
+    /**
+     * \brief Calculate Manhattan distance of \c count packed states.
+     * \param states The packed states.
+     * \param out The distances, should have room for \c count elements.
+     * \param count The number of states.
+     */
+    inline void GetManhattanDistanceBatch(const NPuzzlePackedState* states, int* out, std::size_t count)
+    {
+        HeuristicKernel::GetDispatch().manhattanDistance(states, out, count);
+    }
+
+    /**
+     * \brief Find the batch kernel equivalent to a heuristic function.
+     * \param hFunc The heuristic function.
+     * \return The batch kernel, or \c nullptr if there is no such kernel.
+     */
+    inline HeuristicKernel::BatchKernelT GetBatchKernel(const NPuzzleCostFunction& hFunc)
+    {
+        typedef int (*CostFunctionPtrT)(NPuzzleNode);
+
+        auto func = hFunc.target<CostFunctionPtrT>();
+        if (!packable || !func)
+            return nullptr;
+        if (*func == GetMisplacedTileCount)
+            return GetMisplacedTileCountBatch;
+        if (*func == GetManhattanDistance)
+            return GetManhattanDistanceBatch;
+        return nullptr;
+    }
+}
+
+#endif
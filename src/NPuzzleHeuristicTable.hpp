@@ -0,0 +1,88 @@
+/**
+ * \file NPuzzleHeuristicTable.hpp
+ * \brief A compact hash table from states to costs, such as learned or exact \c h(n).
+ */
+#ifndef __NPUZZLE_HEURISTIC_TABLE__
+#define __NPUZZLE_HEURISTIC_TABLE__
+
+namespace NPuzzle
+{
+    /**
+     * \brief A compact open-addressing table of heuristic costs.
+     *
+     * Boards up to the 15-puzzle are stored as 64-bit keys, 4 bits per cell,
+     * holding the goal position of the tile in each cell. Larger boards store
+     * whole states. The slots are kept in a HashTable.
+     */
+    class NPuzzleHeuristicTable
+    {
+    public:
+        typedef std::conditional<packable, uint64_t, NPuzzleState>::type KeyT;
+
+    private:
+        HashTable<KeyT, int> table;
+        int blankTarget = demonstration;
+
+    public:
+        /**
+         * \param initialCapacity The initial number of slots, should be a power of 2.
+         */
+        explicit NPuzzleHeuristicTable(std::size_t initialCapacity = 1024) : table(initialCapacity) {}
+
+        /**
+         * \brief Remove all values, and set the goal they relate to.
+         * \param canonicalGoal The goal in canonical labels.
+         */
+        void reset(const NPuzzleState& canonicalGoal)
+        {
+            table.clear();
+            blankTarget = static_cast<int>(std::find(canonicalGoal.begin(), canonicalGoal.end(), 0) - canonicalGoal.begin());
+        }
+
+        //! The number of values stored.
+        std::size_t size() const { return table.size(); }
+        //! The memory used by the table in bytes.
+        std::size_t getMemoryUsage() const { return table.getMemoryUsage(); }
+
+        /**
+         * \brief Find the value of a state.
+         * \param state The state in canonical labels.
+         * \param value Set to the value if found.
+         * \return Whether the value is found.
+         */
+        bool find(const NPuzzleState& state, int& value) const
+        {
+            auto found = table.find(makeKey(state));
+            if (!found)
+                return false;
+            value = *found;
+            return true;
+        }
+
+        /**
+         * \brief Set the value of a state.
+         * \param state The state in canonical labels.
+         * \param value The value.
+         */
+        void set(const NPuzzleState& state, int value) { table.set(makeKey(state), value); }
+
+    private:
+        KeyT makeKey(const NPuzzleState& state) const
+        {
+            KeyT key = KeyT();
+            pack(state, key);
+            return key;
+        }
+
+        // Tile t belongs to position t - 1, so positions fit in 4 bits.
+        void pack(const NPuzzleState& state, uint64_t& key) const
+        {
+            for (int i = 0; i <= demonstration; i++)
+                key |= static_cast<uint64_t>(state[i] ? state[i] - 1 : blankTarget) << (4 * i);
+        }
+
+        void pack(const NPuzzleState& state, NPuzzleState& key) const { key = state; }
+    };
+}
+
+#endif
@@ -0,0 +1,126 @@
+/**
+ * \file NPuzzleLazyHeuristic.hpp
+ * \brief A combination of heuristic functions, of which the expensive ones could be deferred.
+ */
+#ifndef __NPUZZLE_LAZY_HEURISTIC__
+#define __NPUZZLE_LAZY_HEURISTIC__
+
+namespace NPuzzle
+{
+    /**
+     * \brief The max of a cheap heuristic function and some expensive ones.
+     *
+     * The max of admissible heuristics is admissible as well. A search could evaluate
+     * all of them at once by getEagerFunction(), or evaluate them one by one with
+     * evaluate(), as NPuzzle::NPuzzleLazySolver does. Either way, each evaluation
+     * is counted and timed, to tell whether an expensive heuristic pays off.
+     */
+    class NPuzzleLazyHeuristic
+    {
+    public:
+        typedef std::chrono::steady_clock ClockT;
+
+        //! The statistic of a heuristic function.
+        struct Statistic
+        {
+            std::string name;
+            //! The number of evaluations.
+            unsigned long evaluations;
+            //! The total time of evaluations in seconds.
+            double seconds;
+        };
+
+    private:
+        struct Component
+        {
+            std::string name;
+            NPuzzleCostFunction hFunc;
+            unsigned long evaluations;
+            ClockT::duration time;
+        };
+
+        // The cheap one comes first.
+        std::vector<Component> components;
+
+    public:
+        NPuzzleLazyHeuristic() : NPuzzleLazyHeuristic("Uniform", GetUniformHeuristicCost) {}
+
+        /**
+         * \param name The name of the cheap heuristic function.
+         * \param cheap The cheap heuristic function, evaluated when a node is generated.
+         */
+        NPuzzleLazyHeuristic(std::string name, NPuzzleCostFunction cheap)
+        {
+            components.push_back(Component{ name, cheap, 0, ClockT::duration::zero() });
+        }
+
+        /**
+         * \brief Add an expensive heuristic function, evaluated when really needed.
+         * \param name The name of the heuristic function.
+         * \param expensive The heuristic function, which should be admissible.
+         */
+        void addDeferred(std::string name, NPuzzleCostFunction expensive)
+        {
+            components.push_back(Component{ name, expensive, 0, ClockT::duration::zero() });
+        }
+
+        //! Get the number of heuristic functions, including the cheap one.
+        std::size_t size() const { return components.size(); }
+
+        /**
+         * \brief Evaluate one of the heuristic functions.
+         * \param index The index of the heuristic function, 0 for the cheap one.
+         * \param node The node to be evaluated.
+         */
+        int evaluate(std::size_t index, const NPuzzleNode& node)
+        {
+            auto& component = components[index];
+            auto start = ClockT::now();
+            int value = component.hFunc(node);
+            component.time += ClockT::now() - start;
+            component.evaluations++;
+            return value;
+        }
+
+        //! Evaluate all heuristic functions, and return the max.
+        int evaluateAll(const NPuzzleNode& node)
+        {
+            int value = 0;
+            for (std::size_t i = 0; i < components.size(); i++)
+                value = std::max(value, evaluate(i, node));
+            return value;
+        }
+
+        /**
+         * \brief Get a heuristic function evaluating all of them eagerly.
+         *
+         * The function refers to this object, which should outlive it.
+         */
+        NPuzzleCostFunction getEagerFunction()
+        {
+            return [this](NPuzzleNode node) { return evaluateAll(node); };
+        }
+
+        //! Get the statistic of each heuristic function, the cheap one first.
+        std::vector<Statistic> getStatistics() const
+        {
+            std::vector<Statistic> statistics;
+            for (auto& component : components)
+                statistics.push_back(Statistic{ component.name, component.evaluations,
+                                                std::chrono::duration<double>(component.time).count() });
+            return statistics;
+        }
+
+        //! Clear the statistic.
+        void resetStatistics()
+        {
+            for (auto& component : components)
+            {
+                component.evaluations = 0;
+                component.time = ClockT::duration::zero();
+            }
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,197 @@
+/**
+ * \file NPuzzleLazySolver.hpp
+ * \brief The solver for N-Puzzle problem based on Lazy A*.
+ *
+ * Nodes are queued with the cheap heuristic only. The expensive ones are evaluated
+ * when a node reaches the top of the queue, so nodes never expanded never pay for them.
+ */
+#ifndef __NPUZZLE_LAZY_SOLVER__
+#define __NPUZZLE_LAZY_SOLVER__
+
+namespace NPuzzle
+{
+    /**
+     * \brief The solver for N-Puzzle problem based on Lazy A*.
+     *
+     * When a node reaches the top of the queue, the deferred heuristics of a
+     * NPuzzle::NPuzzleLazyHeuristic are evaluated in order. As soon as one of
+     * them raises \c f(n), the node is queued again instead of being expanded.
+     * Only after all of them failed to raise it, the node is expanded.
+     *
+     * A state is queued again if it is reached with a smaller depth, so the
+     * solution is optimal with admissible and consistent heuristics.
+     */
+    class NPuzzleLazySolver
+    {
+    private:
+        // Everything known about a state.
+        struct Entry
+        {
+            int depth;
+            // The max of the heuristics evaluated so far, and how many are.
+            int heuristic;
+            std::size_t evaluated;
+            NPuzzleState parent;
+            bool closed;
+        };
+
+        // Parameters
+        NPuzzleLazyHeuristic heuristic;
+
+        // Statistic
+        unsigned long totalNodesExpanded = 0;
+        unsigned long maxQueueLength = 0;
+        unsigned long reinsertions = 0;
+
+        // Last search in canonical labels.
+        std::unordered_map<NPuzzleState, Entry> table;
+        NPuzzleState initialState;
+        NPuzzleGoal goal;
+        NPuzzleNode finalNode;
+
+    public:
+        //! Get the total amount of nodes expanded.
+        unsigned long getTotalNodesExpanded() const { return totalNodesExpanded; }
+        //! Get the max length of the queue.
+        unsigned long getMaxQueueLength() const { return maxQueueLength; }
+        //! Get the number of nodes queued again since a deferred heuristic raised \c f(n).
+        unsigned long getReinsertions() const { return reinsertions; }
+
+        //! Get the heuristics, along with their statistic.
+        const NPuzzleLazyHeuristic& getHeuristic() const { return heuristic; }
+        //! Set the heuristics.
+        void setHeuristic(const NPuzzleLazyHeuristic& heuristic) { this->heuristic = heuristic; }
+
+        /**
+         * \brief Solve the N-Puzzle problem.
+         * \param initialState The intital state.
+         * \param finalState The goal state.
+         * \return The search result.
+         *
+         * The statistic of heuristics keeps accumulating across solves, see
+         * NPuzzle::NPuzzleLazyHeuristic::resetStatistics().
+         */
+        NPuzzleSearchResult solve(NPuzzleState initialState, NPuzzleState finalState)
+        {
+            // Clear the information last search left.
+            table.clear();
+            finalNode = NPuzzleNode();
+            totalNodesExpanded = 0;
+            maxQueueLength = 0;
+            reinsertions = 0;
+
+            goal = NPuzzleGoal(finalState);
+            if (!goal.isSolvable(initialState))
+                return NPuzzleSearchResult::Rejected();
+            initialState = goal.relabel(initialState);
+            this->initialState = initialState;
+            auto canonicalGoal = goal.getCanonicalGoal();
+
+            NPuzzleProblem problem(initialState, canonicalGoal);
+            auto operators = problem.getOperators();
+            NPuzzleQueue open([](const NPuzzleNode& a, const NPuzzleNode& b) {
+                // Less f(n) has higher priority, prefer the deeper one on ties.
+                int fa = a.getDepth() + a.getHeuristic(), fb = b.getDepth() + b.getHeuristic();
+                return fa > fb || (fa == fb && a.getDepth() < b.getDepth());
+            });
+
+            int h = heuristic.evaluate(0, NPuzzleNode(initialState, 0));
+            table[initialState] = Entry{ 0, h, 1, initialState, false };
+            open.push(NPuzzleNode(initialState, 0, h));
+            maxQueueLength = 1;
+
+            while (!open.isEmpty())
+            {
+                auto node = open.top();
+                open.pop();
+                auto state = node.getState();
+                auto& entry = table.at(state);
+                if (entry.closed || node.getDepth() != entry.depth || node.getHeuristic() != entry.heuristic)
+                    continue;
+
+                if (state == canonicalGoal)
+                {
+                    finalNode = node;
+                    return NPuzzleSearchResult::Success(goal.restore(node));
+                }
+
+                // Evaluate deferred heuristics until one raises f(n).
+                bool raised = false;
+                while (!raised && entry.evaluated < heuristic.size())
+                {
+                    int value = heuristic.evaluate(entry.evaluated++, node);
+                    if (value > entry.heuristic)
+                    {
+                        entry.heuristic = value;
+                        raised = true;
+                    }
+                }
+                if (raised)
+                {
+                    node.setHeuristic(entry.heuristic);
+                    open.push(node);
+                    reinsertions++;
+                    continue;
+                }
+
+                entry.closed = true;
+                for (auto& action : operators)
+                {
+                    auto res = action(state);
+                    if (!res.isSucceeded())
+                        continue;
+
+                    auto nextState = res.getState();
+                    int depth = node.getDepth() + res.getCost();
+                    auto found = table.find(nextState);
+                    if (found == table.end())
+                    {
+                        int h = heuristic.evaluate(0, NPuzzleNode(nextState, depth));
+                        auto newEntry = Entry{ std::numeric_limits<int>::max(), h, 1, state, false };
+                        found = table.insert(std::make_pair(nextState, newEntry)).first;
+                    }
+
+                    auto& next = found->second;
+                    if (depth >= next.depth)
+                        continue;
+
+                    next.depth = depth;
+                    next.parent = state;
+                    next.closed = false;
+                    open.push(NPuzzleNode(nextState, depth, next.heuristic));
+                    totalNodesExpanded++;
+                }
+
+                // Is the size of current queue larger than previous?
+                if (open.size() > maxQueueLength)
+                    maxQueueLength = open.size();
+            }
+
+            return NPuzzleSearchResult::Failure();
+        }
+
+        /**
+         * \brief Get the path to the solution if exists.
+         * \return The path, starting with the initial state and excluding the final state.
+         */
+        std::vector<NPuzzleNode> getSolutionPath() const
+        {
+            std::vector<NPuzzleNode> path;
+            if (finalNode.getDepth() == NPuzzleNode::FailureDepth)
+                return path;
+
+            for (auto state = finalNode.getState(); state != initialState; )
+            {
+                state = table.at(state).parent;
+                auto& entry = table.at(state);
+                path.push_back(goal.restore(NPuzzleNode(state, entry.depth)));
+            }
+
+            // The path now is in reverse order, so we reverse it back.
+            std::reverse(path.begin(), path.end());
+            return path;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,722 @@
+/**
+ * \file NPuzzleMacroSolver.hpp
+ * \brief The constructive solver for large boards, placing tiles row by row and column by column.
+ *
+ * The solution is not optimal, but it takes polynomial time, so boards like 100x100
+ * are solved in seconds. Moves are streamed out as they are made, optionally through
+ * NPuzzle::NPuzzleMoveOptimizer to shorten them, so they are never held all at once.
+ */
+#ifndef __NPUZZLE_MACRO_SOLVER__
+#define __NPUZZLE_MACRO_SOLVER__
+
+namespace NPuzzle
+{
+    /**
+     * \brief The type of callbacks receiving moves one by one.
+     *
+     * It should be the following form:
+     * \code
+     * void onMove(NPuzzleMove move)
+     * {
+     *     ...
+     * }
+     * \endcode
+     */
+    typedef std::function<void(NPuzzleMove)> NPuzzleMoveCallback;
+
+    /**
+     * \brief Shortens a stream of moves, holding only a bounded window of them.
+     *
+     * A move undoing the previous one cancels it. Optionally, every \c shortcutLength
+     * moves leaving the window are replaced by a shorter sequence with the same effect,
+     * found by a bounded IDA* over the cells the blank visited, if they are few.
+     * Moves already passed on are never revisited.
+     */
+    class NPuzzleMoveOptimizer
+    {
+    public:
+        //! The max number of cells searched for a shortcut.
+        static constexpr int MaxShortcutCells = 12;
+        //! The max number of nodes searched for a shortcut.
+        static constexpr unsigned long MaxShortcutNodes = 20000;
+
+    private:
+        int width;
+        NPuzzleMoveCallback sink;
+        std::size_t window;
+        std::size_t shortcutLength;
+
+        std::deque<NPuzzleMove> buffer;
+        // The blank before the first move in the buffer.
+        int frontBlank;
+
+        // Statistic
+        unsigned long movesIn = 0;
+        unsigned long movesOut = 0;
+
+        // Shortcut search on a rectangle of cells, tile i + 1 starting at cell i.
+        int rows, cols;
+        std::array<int, MaxShortcutCells> tiles;
+        std::array<int, MaxShortcutCells + 1> targets;
+        std::vector<NPuzzleMove> shortcut;
+        unsigned long shortcutNodes;
+
+    public:
+        /**
+         * \param width The width of the board.
+         * \param blank The cell of the blank before the first move.
+         * \param sink The callback receiving the shortened moves.
+         * \param window The number of moves held for cancelling, at least 1.
+         * \param shortcutLength The length of sequences searched for shortcuts, 0 to disable.
+         */
+        NPuzzleMoveOptimizer(int width, int blank, NPuzzleMoveCallback sink,
+                             std::size_t window = 256, std::size_t shortcutLength = 0)
+            : width(width), sink(sink), window(std::max<std::size_t>(1, window)),
+              shortcutLength(shortcutLength), frontBlank(blank) {}
+
+        //! Get the number of moves received.
+        unsigned long getMovesIn() const { return movesIn; }
+        //! Get the number of moves passed on.
+        unsigned long getMovesOut() const { return movesOut; }
+
+        //! Receive a move.
+        void push(NPuzzleMove move)
+        {
+            movesIn++;
+            if (!buffer.empty() && buffer.back() == inverseMove(move))
+                buffer.pop_back();
+            else
+                buffer.push_back(move);
+
+            std::size_t chunk = std::max<std::size_t>(1, shortcutLength);
+            if (buffer.size() >= window + chunk)
+                emitFront(chunk);
+        }
+
+        //! Pass on all moves held.
+        void flush()
+        {
+            std::size_t chunk = std::max<std::size_t>(1, shortcutLength);
+            while (!buffer.empty())
+                emitFront(std::min(chunk, buffer.size()));
+        }
+
+    private:
+        void emitFront(std::size_t count)
+        {
+            if (shortcutLength && count > 1)
+                count = shortenFront(count);
+
+            for (std::size_t i = 0; i < count; i++)
+            {
+                auto move = buffer.front();
+                buffer.pop_front();
+                frontBlank = step(frontBlank, move);
+                sink(move);
+                movesOut++;
+            }
+        }
+
+        int step(int cell, NPuzzleMove move) const
+        {
+            switch (move)
+            {
+            case NPuzzleMove::Left:  return cell - 1;
+            case NPuzzleMove::Right: return cell + 1;
+            case NPuzzleMove::Up:    return cell - width;
+            default:                 return cell + width;
+            }
+        }
+
+        // Replace the first count moves by a shorter sequence if found, return its length.
+        std::size_t shortenFront(std::size_t count)
+        {
+            // The rectangle the blank visits.
+            int top = frontBlank / width, bottom = top, left = frontBlank % width, right = left;
+            int cell = frontBlank;
+            for (std::size_t i = 0; i < count; i++)
+            {
+                cell = step(cell, buffer[i]);
+                top = std::min(top, cell / width);
+                bottom = std::max(bottom, cell / width);
+                left = std::min(left, cell % width);
+                right = std::max(right, cell % width);
+            }
+            rows = bottom - top + 1;
+            cols = right - left + 1;
+            if (rows * cols > MaxShortcutCells || rows * cols < 4)
+                return count;
+
+            auto local = [&](int index) { return (index / width - top) * cols + index % width - left; };
+
+            // Play the moves on the rectangle to find where each tile ends up.
+            int start = local(frontBlank);
+            for (int i = 0; i < rows * cols; i++)
+                tiles[i] = i == start ? 0 : i + 1;
+            int blank = start;
+            for (std::size_t i = 0; i < count; i++)
+            {
+                int target = localStep(blank, buffer[i]);
+                std::swap(tiles[blank], tiles[target]);
+                blank = target;
+            }
+            for (int i = 0; i < rows * cols; i++)
+                targets[tiles[i]] = i;
+            int end = blank;
+
+            // Search back from the start.
+            for (int i = 0; i < rows * cols; i++)
+                tiles[i] = i == start ? 0 : i + 1;
+            int h = 0;
+            for (int i = 0; i < rows * cols; i++)
+                if (tiles[i])
+                    h += distance(i, targets[tiles[i]]);
+
+            shortcut.clear();
+            shortcutNodes = 0;
+            // The same effect needs a length of the same parity, and it should be shorter.
+            int length = static_cast<int>(count);
+            for (int bound = h + (length - h) % 2; bound < length; bound += 2)
+            {
+                if (searchShortcut(start, end, 0, bound, h, -1))
+                {
+                    buffer.erase(buffer.begin(), buffer.begin() + count);
+                    buffer.insert(buffer.begin(), shortcut.begin(), shortcut.end());
+                    return shortcut.size();
+                }
+                if (shortcutNodes > MaxShortcutNodes)
+                    break;
+            }
+            return count;
+        }
+
+        int localStep(int cell, NPuzzleMove move) const
+        {
+            switch (move)
+            {
+            case NPuzzleMove::Left:  return cell - 1;
+            case NPuzzleMove::Right: return cell + 1;
+            case NPuzzleMove::Up:    return cell - cols;
+            default:                 return cell + cols;
+            }
+        }
+
+        int distance(int a, int b) const { return abs(a / cols - b / cols) + abs(a % cols - b % cols); }
+
+        bool searchShortcut(int blank, int end, int depth, int bound, int h, int previous)
+        {
+            if (depth + h > bound || ++shortcutNodes > MaxShortcutNodes)
+                return false;
+            if (h == 0 && blank == end)
+                return true;
+
+            for (int m = 0; m < 4; m++)
+            {
+                auto move = static_cast<NPuzzleMove>(m);
+                if (previous >= 0 && move == inverseMove(static_cast<NPuzzleMove>(previous)))
+                    continue;
+
+                int row = blank / cols, col = blank % cols;
+                if ((move == NPuzzleMove::Left && col == 0) || (move == NPuzzleMove::Right && col == cols - 1) ||
+                    (move == NPuzzleMove::Up && row == 0) || (move == NPuzzleMove::Down && row == rows - 1))
+                    continue;
+
+                int next = localStep(blank, move);
+                int tile = tiles[next];
+                int newH = h - distance(next, targets[tile]) + distance(blank, targets[tile]);
+                std::swap(tiles[blank], tiles[next]);
+                shortcut.push_back(move);
+
+                if (searchShortcut(next, end, depth + 1, bound, newH, m))
+                    return true;
+
+                shortcut.pop_back();
+                std::swap(tiles[blank], tiles[next]);
+            }
+            return false;
+        }
+    };
+
+    /**
+     * \brief The constructive solver for boards of any width.
+     *
+     * While the unsolved region is larger than 2x2, its longer side is shrunk by
+     * solving the outermost row (or column) away from the goal of the blank:
+     * - All but the last two tiles are moved one step at a time, first along the
+     *   line then across it, with the blank routed around the tile and solved cells.
+     * - The last two tiles are brought next to their cells, then finished by a
+     *   breadth-first search over the few cells around the end of the line.
+     *
+     * The remaining 2x2 region is solved by a breadth-first search as well. Every
+     * step costs time linear in the width, so the whole solve is polynomial.
+     */
+    class NPuzzleMacroSolver
+    {
+    private:
+        // Parameters
+        std::size_t optimizerWindow = 0;
+        std::size_t shortcutLength = 0;
+
+        // The board in canonical labels, tile t belongs to cell t - 1.
+        int width = 0;
+        std::vector<int> cells;
+        std::vector<int> position;
+        std::vector<char> locked;
+        int blank = 0;
+        int blankGoal = 0;
+        NPuzzleMoveCallback emit;
+
+        // Statistic
+        unsigned long movesGenerated = 0;
+        unsigned long movesEmitted = 0;
+
+        // The line being solved is the top row of a view, which maps (row, col)
+        // of the view onto the board, transposed and/or rotated by 180 degrees.
+        bool transposed = false;
+        bool rotated = false;
+
+        // Scratch of breadth-first searches over cells.
+        std::vector<unsigned> visitStamp;
+        std::vector<int> previousCell;
+        std::vector<int> cellQueue;
+        unsigned stamp = 0;
+
+    public:
+        //! Get the number of moves held for cancelling inverse pairs, 0 if disabled.
+        std::size_t getOptimizerWindow() const { return optimizerWindow; }
+        /**
+         * \brief Set the number of moves held for cancelling inverse pairs.
+         * \param optimizerWindow The number of moves, 0 (the default) to pass moves on unchanged.
+         *
+         * The solver never emits a move undoing the previous one, so the window alone
+         * shortens nothing. Paths are only shortened by setShortcutLength(), which
+         * searches the moves held in the window.
+         */
+        void setOptimizerWindow(std::size_t optimizerWindow) { this->optimizerWindow = optimizerWindow; }
+
+        //! Get the length of move sequences searched for shortcuts, 0 if disabled.
+        std::size_t getShortcutLength() const { return shortcutLength; }
+        /**
+         * \brief Set the length of move sequences searched for shortcuts.
+         * \param shortcutLength The length, 0 to disable. Only applies if the optimizer window is not 0.
+         *
+         * This is the pass which shortens paths, at the cost of a bounded IDA* per sequence.
+         */
+        void setShortcutLength(std::size_t shortcutLength) { this->shortcutLength = shortcutLength; }
+
+        //! Get the number of moves made by the last solve, before shortening.
+        unsigned long getMovesGenerated() const { return movesGenerated; }
+        //! Get the number of moves passed to the callback by the last solve.
+        unsigned long getMovesEmitted() const { return movesEmitted; }
+
+        /**
+         * \brief Solve a board, streaming moves to a callback.
+         * \param initial The initial board.
+         * \param goal The goal board of the same width.
+         * \param onMove The callback receiving the moves of the blank in order.
+         * \return False if the initial board could not reach the goal.
+         */
+        bool solve(const NPuzzleBoard& initial, const NPuzzleBoard& goal, NPuzzleMoveCallback onMove)
+        {
+            movesGenerated = movesEmitted = 0;
+            if (!initial.isSolvable(goal))
+                return false;
+
+            width = initial.getWidth();
+            int size = initial.size();
+
+            // Relabel, so that the tile at cell i of the goal becomes i + 1.
+            std::vector<int> toCanonical(size);
+            for (int i = 0; i < size; i++)
+                toCanonical[goal.at(i)] = goal.at(i) ? i + 1 : 0;
+            blankGoal = goal.getBlank();
+
+            cells.assign(size, 0);
+            position.assign(size + 1, 0);
+            for (int i = 0; i < size; i++)
+            {
+                cells[i] = toCanonical[initial.at(i)];
+                position[cells[i]] = i;
+            }
+            blank = initial.getBlank();
+            locked.assign(size, 0);
+            visitStamp.assign(size, 0);
+            previousCell.assign(size, -1);
+            stamp = 0;
+
+            std::unique_ptr<NPuzzleMoveOptimizer> optimizer;
+            if (optimizerWindow)
+            {
+                optimizer.reset(new NPuzzleMoveOptimizer(width, blank, [&](NPuzzleMove move) {
+                    movesEmitted++;
+                    onMove(move);
+                }, optimizerWindow, shortcutLength));
+                emit = [&](NPuzzleMove move) { optimizer->push(move); };
+            }
+            else
+            {
+                emit = [&](NPuzzleMove move) {
+                    movesEmitted++;
+                    onMove(move);
+                };
+            }
+
+            bool solved = true;
+            int top = 0, bottom = width, left = 0, right = width;
+            while (solved && (bottom - top > 2 || right - left > 2))
+            {
+                if (bottom - top >= right - left)
+                {
+                    // Solve the top row, or the bottom one if the blank belongs to the top.
+                    transposed = false;
+                    rotated = blankGoal / width == top;
+                    if (rotated)
+                        solved = solveLine(width - bottom, width - right, width - left), bottom--;
+                    else
+                        solved = solveLine(top, left, right), top++;
+                }
+                else
+                {
+                    transposed = true;
+                    rotated = blankGoal % width == left;
+                    if (rotated)
+                        solved = solveLine(width - right, width - bottom, width - top), right--;
+                    else
+                        solved = solveLine(left, top, bottom), left++;
+                }
+            }
+
+            // The last 2x2 region.
+            std::vector<int> region, labels;
+            for (int row = top; row < bottom; row++)
+                for (int col = left; col < right; col++)
+                {
+                    int index = row * width + col;
+                    region.push_back(index);
+                    if (index != blankGoal)
+                        labels.push_back(index + 1);
+                }
+            solved = solved && solveWindow(region, labels);
+
+            if (optimizer)
+                optimizer->flush();
+            emit = NPuzzleMoveCallback();
+            return solved;
+        }
+
+    private:
+        // Map (row, col) of the view onto the board.
+        int cellOf(int row, int col) const
+        {
+            if (transposed)
+                std::swap(row, col);
+            if (rotated)
+            {
+                row = width - 1 - row;
+                col = width - 1 - col;
+            }
+            return row * width + col;
+        }
+
+        int rowOf(int cell) const
+        {
+            int row = cell / width, col = cell % width;
+            if (rotated)
+            {
+                row = width - 1 - row;
+                col = width - 1 - col;
+            }
+            return transposed ? col : row;
+        }
+
+        int colOf(int cell) const
+        {
+            int row = cell / width, col = cell % width;
+            if (rotated)
+            {
+                row = width - 1 - row;
+                col = width - 1 - col;
+            }
+            return transposed ? row : col;
+        }
+
+        // Solve the top row of the region in the view, whose columns are [left, right).
+        bool solveLine(int top, int left, int right)
+        {
+            for (int col = left; col + 2 < right; col++)
+            {
+                int cell = cellOf(top, col);
+                if (!placeTile(cell + 1, cell))
+                    return false;
+                locked[cell] = 1;
+            }
+
+            // The last two tiles, a belongs to the left of b.
+            int cellA = cellOf(top, right - 2), cellB = cellOf(top, right - 1);
+            int a = cellA + 1, b = cellB + 1;
+
+            std::vector<int> window;
+            for (int row = top; row < top + 3; row++)
+                for (int col = std::max(left, right - 3); col < right; col++)
+                    if (!locked[cellOf(row, col)])
+                        window.push_back(cellOf(row, col));
+            auto inWindow = [&](int cell) { return std::find(window.begin(), window.end(), cell) != window.end(); };
+
+            if (!inWindow(position[a]) || !inWindow(position[b]))
+            {
+                // Put b at the cell of a, then a below it.
+                if (!placeTile(b, cellA))
+                    return false;
+                if (!inWindow(position[a]))
+                {
+                    locked[cellA] = 1;
+                    bool placed = placeTile(a, cellOf(top + 1, right - 2));
+                    locked[cellA] = 0;
+                    if (!placed)
+                        return false;
+                }
+            }
+
+            std::vector<int> labels{ a, b };
+            if (!solveWindow(window, labels))
+                return false;
+            locked[cellA] = locked[cellB] = 1;
+            return true;
+        }
+
+        // Move a tile to a cell, one step at a time. False if it is stuck, which should not happen.
+        bool placeTile(int tile, int target)
+        {
+            while (position[tile] != target)
+            {
+                int cell = position[tile];
+                int row = rowOf(cell), col = colOf(cell);
+                int targetRow = rowOf(target), targetCol = colOf(target);
+
+                // Along the line first, then across it.
+                int candidates[2] = { -1, -1 };
+                if (col != targetCol)
+                    candidates[0] = cellOf(row, col + (targetCol > col ? 1 : -1));
+                if (row != targetRow)
+                    candidates[1] = cellOf(row + (targetRow > row ? 1 : -1), col);
+
+                bool moved = false;
+                for (int next : candidates)
+                {
+                    if (next < 0 || locked[next])
+                        continue;
+
+                    locked[cell] = 1;
+                    bool reached = moveBlank(next);
+                    locked[cell] = 0;
+                    if (reached)
+                    {
+                        moveBlankInto(cell);
+                        moved = true;
+                        break;
+                    }
+                }
+
+                if (!moved)
+                    return false;
+            }
+            return true;
+        }
+
+        // Move the blank to a cell without passing locked cells.
+        bool moveBlank(int target)
+        {
+            // Head straight for the target while far away.
+            int targetRow = target / width, targetCol = target % width;
+            while (true)
+            {
+                int row = blank / width, col = blank % width;
+                int rowDistance = abs(targetRow - row), colDistance = abs(targetCol - col);
+                if (rowDistance + colDistance <= 3)
+                    break;
+
+                int vertical = blank + (targetRow > row ? width : -width);
+                int horizontal = blank + (targetCol > col ? 1 : -1);
+                int first = rowDistance >= colDistance ? vertical : horizontal;
+                int second = rowDistance >= colDistance ? horizontal : vertical;
+                int secondDistance = rowDistance >= colDistance ? colDistance : rowDistance;
+
+                if (!locked[first])
+                    moveBlankInto(first);
+                else if (secondDistance && !locked[second])
+                    moveBlankInto(second);
+                else
+                    break;
+            }
+
+            if (blank == target)
+                return true;
+
+            // Then search around, in a box first, then the whole board.
+            int top = std::min(blank / width, targetRow) - 2, bottom = std::max(blank / width, targetRow) + 2;
+            int left = std::min(blank % width, targetCol) - 2, right = std::max(blank % width, targetCol) + 2;
+            return routeBlank(target, std::max(0, top), std::min(width - 1, bottom),
+                              std::max(0, left), std::min(width - 1, right)) ||
+                   routeBlank(target, 0, width - 1, 0, width - 1);
+        }
+
+        // Breadth-first search for the blank within a box, inclusive.
+        bool routeBlank(int target, int top, int bottom, int left, int right)
+        {
+            stamp++;
+            cellQueue.clear();
+            cellQueue.push_back(blank);
+            visitStamp[blank] = stamp;
+            previousCell[blank] = -1;
+
+            for (std::size_t head = 0; head < cellQueue.size() && visitStamp[target] != stamp; head++)
+            {
+                int cell = cellQueue[head];
+                int row = cell / width, col = cell % width;
+                int neighbors[4] = {
+                    col > left ? cell - 1 : -1, col < right ? cell + 1 : -1,
+                    row > top ? cell - width : -1, row < bottom ? cell + width : -1
+                };
+                for (int next : neighbors)
+                {
+                    if (next < 0 || locked[next] || visitStamp[next] == stamp)
+                        continue;
+                    visitStamp[next] = stamp;
+                    previousCell[next] = cell;
+                    cellQueue.push_back(next);
+                }
+            }
+
+            if (visitStamp[target] != stamp)
+                return false;
+
+            std::vector<int> path;
+            for (int cell = target; cell != blank; cell = previousCell[cell])
+                path.push_back(cell);
+            for (auto it = path.rbegin(); it != path.rend(); ++it)
+                moveBlankInto(*it);
+            return true;
+        }
+
+        // Swap the blank with a neighboring cell.
+        void moveBlankInto(int cell)
+        {
+            NPuzzleMove move;
+            if (cell == blank - 1)
+                move = NPuzzleMove::Left;
+            else if (cell == blank + 1)
+                move = NPuzzleMove::Right;
+            else if (cell == blank - width)
+                move = NPuzzleMove::Up;
+            else
+                move = NPuzzleMove::Down;
+
+            int tile = cells[cell];
+            cells[blank] = tile;
+            position[tile] = blank;
+            cells[cell] = 0;
+            position[0] = cell;
+            blank = cell;
+
+            movesGenerated++;
+            emit(move);
+        }
+
+        /**
+         * Breadth-first search for moves of the blank within a few cells, until
+         * each of the labels is at its own cell. The labels should be in the window,
+         * which has at most 16 cells, and at most 3 labels are tracked.
+         */
+        bool solveWindow(const std::vector<int>& window, const std::vector<int>& labels)
+        {
+            // Bring the blank into the window.
+            if (std::find(window.begin(), window.end(), blank) == window.end())
+            {
+                for (auto label : labels)
+                    locked[position[label]] = 1;
+                for (auto cell : window)
+                    if (cells[cell] == 0 || std::find(labels.begin(), labels.end(), cells[cell]) == labels.end())
+                        if (moveBlank(cell))
+                            break;
+                for (auto label : labels)
+                    locked[position[label]] = 0;
+            }
+
+            int count = static_cast<int>(window.size());
+            auto indexOf = [&](int cell) {
+                return static_cast<int>(std::find(window.begin(), window.end(), cell) - window.begin());
+            };
+
+            // A state packs the window index of the blank, then of each label.
+            auto encode = [&](const std::vector<int>& where) {
+                uint32_t key = 0;
+                for (auto index : where)
+                    key = key * 16 + static_cast<uint32_t>(index);
+                return key;
+            };
+
+            std::vector<int> where{ indexOf(blank) };
+            std::vector<int> goalWhere{ -1 };
+            for (auto label : labels)
+            {
+                where.push_back(indexOf(position[label]));
+                goalWhere.push_back(indexOf(label - 1));
+            }
+
+            // The blank could be anywhere else.
+            auto isGoal = [&](const std::vector<int>& state) {
+                return std::equal(state.begin() + 1, state.end(), goalWhere.begin() + 1);
+            };
+
+            std::unordered_map<uint32_t, uint32_t> parent;
+            std::deque<std::vector<int>> frontier{ where };
+            parent[encode(where)] = encode(where);
+            std::vector<int> found;
+            while (!frontier.empty())
+            {
+                auto state = frontier.front();
+                frontier.pop_front();
+                if (isGoal(state))
+                {
+                    found = state;
+                    break;
+                }
+
+                int cell = window[state[0]];
+                int row = cell / width, col = cell % width;
+                int neighbors[4] = {
+                    col > 0 ? cell - 1 : -1, col + 1 < width ? cell + 1 : -1,
+                    row > 0 ? cell - width : -1, row + 1 < width ? cell + width : -1
+                };
+                for (int next : neighbors)
+                {
+                    int index = next < 0 ? count : indexOf(next);
+                    if (index == count)
+                        continue;
+
+                    auto nextState = state;
+                    nextState[0] = index;
+                    for (std::size_t i = 1; i < nextState.size(); i++)
+                        if (nextState[i] == index)
+                            nextState[i] = state[0];
+
+                    if (parent.insert(std::make_pair(encode(nextState), encode(state))).second)
+                        frontier.push_back(nextState);
+                }
+            }
+
+            if (found.empty())
+                return false;
+
+            // Trace the blank back to the start.
+            std::vector<int> path;
+            for (uint32_t key = encode(found), start = encode(where); key != start; key = parent[key])
+                path.push_back(window[key >> (4 * labels.size())]);
+            for (auto it = path.rbegin(); it != path.rend(); ++it)
+                moveBlankInto(*it);
+            return true;
+        }
+    };
+}
+
+#endif
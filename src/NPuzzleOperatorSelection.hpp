@@ -0,0 +1,91 @@
+/**
+ * \file NPuzzleOperatorSelection.hpp
+ * \brief Precomputed changes of heuristics by a single move, used to select operators.
+ *
+ * A move only changes the position of one tile, so the change of \c h(n) is
+ * known before evaluating the child. Enhanced Partial Expansion A* (EPEA*) uses it
+ * to enqueue only the children whose \c f(n) equals the one stored in their parent.
+ */
+#ifndef __NPUZZLE_OPERATOR_SELECTION__
+#define __NPUZZLE_OPERATOR_SELECTION__
+
+namespace NPuzzle
+{
+    /**
+     * \brief The table of heuristic changes by moving a tile into the blank.
+     *
+     * The table is indexed by the tile (in canonical labels), the position it
+     * moves from, and the blank position it moves to. Only heuristics which sum
+     * up a cost per tile have such a table, namely NPuzzle::GetMisplacedTileCount,
+     * NPuzzle::GetManhattanDistance and NPuzzle::GetUniformHeuristicCost.
+     */
+    class NPuzzleOperatorSelection
+    {
+    private:
+        static constexpr int Cells = demonstration + 1;
+        static constexpr int Labels = demonstration + 2;
+
+        std::vector<int> delta;
+
+    public:
+        //! Create an empty table, see isAvailable().
+        NPuzzleOperatorSelection() {}
+
+        /**
+         * \param tileCost The cost of a tile at a position, which sums up to \c h(n).
+         */
+        explicit NPuzzleOperatorSelection(std::function<int(int, int)> tileCost)
+            : delta(Labels * Cells * Cells, 0)
+        {
+            for (int tile = 1; tile < Labels; tile++)
+                for (int from = 0; from < Cells; from++)
+                    for (int to = 0; to < Cells; to++)
+                        delta[index(tile, from, to)] = tileCost(tile, to) - tileCost(tile, from);
+        }
+
+        /**
+         * \brief Build the table for a heuristic function.
+         * \param hFunc The heuristic function.
+         * \return The table, which is not available if \c hFunc has none.
+         */
+        static NPuzzleOperatorSelection ForHeuristic(const NPuzzleCostFunction& hFunc)
+        {
+            typedef int (*CostFunctionPtrT)(NPuzzleNode);
+
+            auto func = hFunc.target<CostFunctionPtrT>();
+            if (!func)
+                return NPuzzleOperatorSelection();
+
+            if (*func == GetUniformHeuristicCost)
+                return NPuzzleOperatorSelection([](int, int) { return 0; });
+            if (*func == GetMisplacedTileCount)
+                return NPuzzleOperatorSelection([](int tile, int position) {
+                    return tile - 1 != position ? 1 : 0;
+                });
+            if (*func == GetManhattanDistance)
+                return NPuzzleOperatorSelection([](int tile, int position) {
+                    int row, col, targetRow, targetCol;
+                    indexToMatrix(position, row, col);
+                    indexToMatrix(tile - 1, targetRow, targetCol);
+                    return abs(targetRow - row) + abs(targetCol - col);
+                });
+            return NPuzzleOperatorSelection();
+        }
+
+        //! Whether the table is built.
+        bool isAvailable() const { return !delta.empty(); }
+
+        /**
+         * \brief Get the change of \c h(n) by a move.
+         * \param tile The tile moved, in canonical labels.
+         * \param from The position the tile moves from, which becomes blank.
+         * \param to The blank position the tile moves to.
+         */
+        int getDelta(int tile, int from, int to) const { return delta[index(tile, from, to)]; }
+
+    private:
+        static int index(int tile, int from, int to) { return (tile * Cells + from) * Cells + to; }
+    };
+}
+
+#endif
@@ -0,0 +1,158 @@
+/**
+ * \file NPuzzlePerimeter.hpp
+ * \brief The perimeter around a goal state, the exact costs of all states near it.
+ *
+ * A perimeter is built once by a backward breadth-first search, and shared
+ * read-only by every search toward the same goal, even in different threads.
+ */
+#ifndef __NPUZZLE_PERIMETER__
+#define __NPUZZLE_PERIMETER__
+
+namespace NPuzzle
+{
+    /**
+     * \brief The exact costs to a goal state of all states within a radius.
+     *
+     * Inside the radius, the cost is an exact \c h(n). Outside, the cost is at least
+     * <tt>radius + 1</tt>, which refines any admissible \c h(n) as well. A search could
+     * stop as soon as it reaches the perimeter, and finish the path by descending it.
+     *
+     * Costs are stored in canonical labels of the goal, see NPuzzle::NPuzzleGoal.
+     * All const members are safe to be called from several threads at once.
+     */
+    class NPuzzlePerimeter
+    {
+    private:
+        NPuzzleGoal goal;
+        int radius;
+        NPuzzleHeuristicTable costs;
+
+    public:
+        /**
+         * \param finalState The goal state.
+         * \param radius The max cost of states stored.
+         */
+        NPuzzlePerimeter(NPuzzleState finalState, int radius) : goal(finalState), radius(radius)
+        {
+            auto canonicalGoal = goal.getCanonicalGoal();
+            costs.reset(canonicalGoal);
+            costs.set(canonicalGoal, 0);
+
+            NPuzzleProblem problem(canonicalGoal, canonicalGoal);
+            auto operators = problem.getOperators();
+            std::vector<NPuzzleState> layer{ canonicalGoal }, nextLayer;
+            for (int cost = 1; cost <= radius && !layer.empty(); cost++)
+            {
+                nextLayer.clear();
+                for (auto& state : layer)
+                {
+                    for (auto& action : operators)
+                    {
+                        auto res = action(state);
+                        int known;
+                        if (!res.isSucceeded() || costs.find(res.getState(), known))
+                            continue;
+                        costs.set(res.getState(), cost);
+                        nextLayer.push_back(res.getState());
+                    }
+                }
+                layer.swap(nextLayer);
+            }
+        }
+
+        //! Get the goal state in original labels.
+        NPuzzleState getGoalState() const { return goal.getGoalState(); }
+        //! Get the max cost of states stored.
+        int getRadius() const { return radius; }
+        //! Get the number of states stored.
+        std::size_t size() const { return costs.size(); }
+        //! Get the memory used by the perimeter in bytes.
+        std::size_t getMemoryUsage() const { return costs.getMemoryUsage(); }
+
+        /**
+         * \brief Find the exact cost of a state.
+         * \param state The state in canonical labels.
+         * \param cost Set to the cost if found.
+         * \return Whether the state is within the radius.
+         */
+        bool find(const NPuzzleState& state, int& cost) const { return costs.find(state, cost); }
+
+        /**
+         * \brief Get a heuristic function refined by the perimeter.
+         * \param hFunc An admissible heuristic function.
+         * \return The exact cost inside the radius, the max of \c hFunc and
+         * <tt>radius + 1</tt> outside. It refers to this object, which should outlive it.
+         */
+        NPuzzleCostFunction refine(NPuzzleCostFunction hFunc) const
+        {
+            return [this, hFunc](NPuzzleNode node) {
+                int cost;
+                if (costs.find(node.getState(), cost))
+                    return cost;
+                return std::max(hFunc(node), radius + 1);
+            };
+        }
+
+        /**
+         * \brief Get the path from a state inside the radius to the goal.
+         * \param state The state in canonical labels, which should be inside the radius.
+         * \return The path in canonical labels, starting with \c state and excluding the goal.
+         */
+        std::vector<NPuzzleState> descend(NPuzzleState state) const
+        {
+            NPuzzleProblem problem(state, goal.getCanonicalGoal());
+            auto operators = problem.getOperators();
+            std::vector<NPuzzleState> path;
+
+            int cost;
+            if (!costs.find(state, cost))
+                return path;
+            // Each state has a neighbor one step closer, except the goal.
+            while (cost > 0)
+            {
+                path.push_back(state);
+                for (auto& action : operators)
+                {
+                    auto res = action(state);
+                    int nextCost;
+                    if (res.isSucceeded() && costs.find(res.getState(), nextCost) && nextCost == cost - 1)
+                    {
+                        state = res.getState();
+                        cost = nextCost;
+                        break;
+                    }
+                }
+            }
+            return path;
+        }
+    };
+
+    /**
+     * \brief The N-Puzzle problem whose goal test passes on reaching a perimeter.
+     *
+     * Without a perimeter, it is the same as NPuzzle::NPuzzleProblem.
+     */
+    class NPuzzlePerimeterProblem : public NPuzzleProblem
+    {
+    private:
+        const NPuzzlePerimeter* perimeter;
+
+    public:
+        /**
+         * \param initialState The initial state in canonical labels.
+         * \param finalState The final state in canonical labels.
+         * \param perimeter The perimeter around the final state, or \c nullptr.
+         */
+        NPuzzlePerimeterProblem(NPuzzleState initialState, NPuzzleState finalState, const NPuzzlePerimeter* perimeter)
+            : NPuzzleProblem(initialState, finalState), perimeter(perimeter) {}
+
+        //! \copydoc Problem::goalTest
+        bool goalTest(NPuzzleState state)
+        {
+            int cost;
+            return perimeter ? perimeter->find(state, cost) : NPuzzleProblem::goalTest(state);
+        }
+    };
+}
+
+#endif
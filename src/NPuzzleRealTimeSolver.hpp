@@ -0,0 +1,321 @@
+/**
+ * \file NPuzzleRealTimeSolver.hpp
+ * \brief The real-time solver for N-Puzzle problem, based on LRTA* with a local search space.
+ *
+ * Rather than planning the whole path before the first move, the solver commits
+ * one move per step after a bounded lookahead, and learns a better \c h(n) for the
+ * states it looked at. Learned values survive between trials, so solving the same
+ * problem repeatedly converges to an optimal path.
+ */
+#ifndef __NPUZZLE_REAL_TIME_SOLVER__
+#define __NPUZZLE_REAL_TIME_SOLVER__
+
+namespace NPuzzle
+{
+    /**
+     * \brief The real-time solver for N-Puzzle problem.
+     *
+     * Each step runs A* from the current state for at most \c lookahead expansions,
+     * then raises \c h(n) of the expanded states to the cost of reaching the frontier
+     * from them (LSS-LRTA*), and moves to the neighbor with the least
+     * <tt>moveCost + h(n)</tt>. A lookahead of 1 is the classic LRTA*.
+     *
+     * Moves are streamed by step(), so the first one is available right after
+     * start(). With an admissible \c h(n), learned values stay admissible, and
+     * repeated trials with the same goal converge to an optimal path.
+     */
+    class NPuzzleRealTimeSolver
+    {
+    private:
+        // A state in the local search space of a step.
+        struct LocalEntry
+        {
+            int depth;
+            int heuristic;
+            bool closed;
+
+            LocalEntry(int depth, int heuristic) : depth(depth), heuristic(heuristic), closed(false) {}
+        };
+
+        // Parameters
+        NPuzzleCostFunction hFunc;
+        std::size_t lookahead = 1;
+        std::size_t maxStepWork = 4096;
+
+        // Learned h(n) in canonical labels.
+        NPuzzleHeuristicTable learned;
+        NPuzzleState learnedGoal;
+
+        // Current trial
+        NPuzzleGoal goal;
+        std::vector<NPuzzleProblem::OperatorT> operators;
+        NPuzzleState currentState = NPuzzleState();
+        int moves = 0;
+        bool started = false;
+        bool finished = true;
+
+        // Statistic
+        unsigned long totalNodesExpanded = 0;
+        unsigned long lastStepWork = 0;
+        unsigned long trialUpdates = 0;
+
+        // Reused by every step.
+        std::unordered_map<NPuzzleState, LocalEntry> local;
+        std::vector<NPuzzleState> closedStates;
+
+    public:
+        NPuzzleRealTimeSolver() { learnedGoal.fill(0); }
+
+        //! Get the heuristic function (\c h(n)).
+        NPuzzleCostFunction getHeuristicFunction() const { return hFunc; }
+        /**
+         * \brief Set the heuristic function (\c h(n)), which should be admissible.
+         *
+         * Values learned with the previous function are forgotten.
+         */
+        void setHeuristicFunction(NPuzzleCostFunction hFunc)
+        {
+            this->hFunc = hFunc;
+            forget();
+        }
+
+        //! Get the max number of nodes expanded by the lookahead of a step.
+        std::size_t getLookahead() const { return lookahead; }
+        //! Set the max number of nodes expanded by the lookahead of a step, at least 1.
+        void setLookahead(std::size_t lookahead) { this->lookahead = std::max<std::size_t>(1, lookahead); }
+
+        //! Get the hard cap on nodes generated by a step.
+        std::size_t getMaxStepWork() const { return maxStepWork; }
+        /**
+         * \brief Set the hard cap on nodes generated by a step.
+         *
+         * The lookahead stops early if it is reached, so the latency of a step is
+         * bounded no matter how large the lookahead is. The neighbors of the
+         * current state are always generated.
+         */
+        void setMaxStepWork(std::size_t maxStepWork) { this->maxStepWork = maxStepWork; }
+
+        //! Forget all learned heuristic costs.
+        void forget()
+        {
+            learned.reset(learnedGoal);
+        }
+
+        //! Get the number of states with a learned heuristic cost.
+        std::size_t getLearnedCount() const { return learned.size(); }
+        //! Get the memory used by learned heuristic costs in bytes.
+        std::size_t getLearnedMemoryUsage() const { return learned.getMemoryUsage(); }
+
+        //! Get the total amount of nodes expanded in the current trial.
+        unsigned long getTotalNodesExpanded() const { return totalNodesExpanded; }
+        //! Get the number of nodes generated by the last step.
+        unsigned long getLastStepWork() const { return lastStepWork; }
+        /**
+         * \brief Get the number of heuristic costs raised in the current trial.
+         *
+         * Once a whole trial raises none, trials have converged.
+         */
+        unsigned long getTrialUpdates() const { return trialUpdates; }
+
+        /**
+         * \brief Start a trial.
+         * \param initialState The intital state.
+         * \param finalState The goal state. Learned values are kept if it is unchanged.
+         * \return False if the initial state could not reach the goal state.
+         */
+        bool start(NPuzzleState initialState, NPuzzleState finalState)
+        {
+            started = false;
+            finished = true;
+            // The goal is only replaced once the trial is accepted.
+            NPuzzleGoal trialGoal(finalState);
+            if (!trialGoal.isSolvable(initialState))
+                return false;
+            goal = trialGoal;
+
+            if (goal.getCanonicalGoal() != learnedGoal)
+            {
+                learnedGoal = goal.getCanonicalGoal();
+                forget();
+            }
+
+            currentState = goal.relabel(initialState);
+            operators = NPuzzleProblem(currentState, learnedGoal).getOperators();
+            moves = 0;
+            finished = currentState == learnedGoal;
+            totalNodesExpanded = 0;
+            lastStepWork = 0;
+            trialUpdates = 0;
+            started = true;
+            return true;
+        }
+
+        //! Whether the goal is reached, or no trial is started, or the last one was rejected.
+        bool isFinished() const { return finished; }
+
+        /**
+         * \brief Look ahead, learn, and commit the next move.
+         * \return The state after the move in original labels, whose depth is the number of moves so far,
+         * or a node with NPuzzle::NPuzzleNode::FailureDepth if no trial is started or the last one was rejected.
+         */
+        NPuzzleNode step()
+        {
+            if (!started)
+                return NPuzzleNode();
+            if (finished)
+                return goal.restore(NPuzzleNode(currentState, moves));
+
+            lastStepWork = 0;
+            lookAhead();
+            learn();
+
+            // Move to the neighbor with the least cost to go.
+            NPuzzleState bestState;
+            int bestCost = std::numeric_limits<int>::max();
+            for (auto& action : operators)
+            {
+                auto res = action(currentState);
+                if (!res.isSucceeded())
+                    continue;
+
+                int cost = res.getCost() + getHeuristic(res.getState());
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestState = res.getState();
+                }
+            }
+
+            currentState = bestState;
+            moves++;
+            finished = currentState == learnedGoal;
+            return goal.restore(NPuzzleNode(currentState, moves));
+        }
+
+    private:
+        int getHeuristic(const NPuzzleState& state) const
+        {
+            int value;
+            if (learned.find(state, value))
+                return value;
+            return hFunc(NPuzzleNode(state, 0));
+        }
+
+        // A* from the current state, stopping at the goal or the lookahead.
+        void lookAhead()
+        {
+            local.clear();
+            closedStates.clear();
+
+            NPuzzleQueue open([](const NPuzzleNode& a, const NPuzzleNode& b) {
+                int fa = a.getDepth() + a.getHeuristic(), fb = b.getDepth() + b.getHeuristic();
+                return fa > fb || (fa == fb && a.getDepth() < b.getDepth());
+            });
+            int h = getHeuristic(currentState);
+            local.insert(std::make_pair(currentState, LocalEntry(0, h)));
+            open.push(NPuzzleNode(currentState, 0, h));
+
+            while (!open.isEmpty() && closedStates.size() < lookahead)
+            {
+                auto node = open.top();
+                open.pop();
+                auto state = node.getState();
+                auto& entry = local.at(state);
+                if (entry.closed || node.getDepth() != entry.depth)
+                    continue;
+                if (state == learnedGoal)
+                    break;
+
+                // The current state is always expanded, otherwise there is no move.
+                if (!closedStates.empty() && lastStepWork + operators.size() > maxStepWork)
+                    break;
+
+                entry.closed = true;
+                closedStates.push_back(state);
+
+                for (auto& action : operators)
+                {
+                    auto res = action(state);
+                    if (!res.isSucceeded())
+                        continue;
+
+                    auto nextState = res.getState();
+                    int depth = node.getDepth() + res.getCost();
+                    lastStepWork++;
+
+                    auto found = local.find(nextState);
+                    if (found == local.end())
+                    {
+                        auto entry = LocalEntry(std::numeric_limits<int>::max(), getHeuristic(nextState));
+                        found = local.insert(std::make_pair(nextState, entry)).first;
+                    }
+                    if (found->second.closed || depth >= found->second.depth)
+                        continue;
+
+                    found->second.depth = depth;
+                    open.push(NPuzzleNode(nextState, depth, found->second.heuristic));
+                    totalNodesExpanded++;
+                }
+            }
+        }
+
+        // Dijkstra from the frontier backwards, over the expanded states.
+        void learn()
+        {
+            const int infinity = std::numeric_limits<int>::max();
+            for (auto& state : closedStates)
+                local.at(state).depth = infinity;
+
+            // Here the depth of a local entry is its learned cost to go.
+            NPuzzleQueue frontier([](const NPuzzleNode& a, const NPuzzleNode& b) {
+                return a.getDepth() > b.getDepth();
+            });
+            for (auto& pair : local)
+                if (!pair.second.closed)
+                    frontier.push(NPuzzleNode(pair.first, pair.second.heuristic));
+            for (auto& pair : local)
+                if (!pair.second.closed)
+                    pair.second.depth = pair.second.heuristic;
+
+            while (!frontier.isEmpty())
+            {
+                auto node = frontier.top();
+                frontier.pop();
+                auto state = node.getState();
+                if (node.getDepth() != local.at(state).depth)
+                    continue;
+
+                // Moves are reversible, so predecessors are the neighbors.
+                for (auto& action : operators)
+                {
+                    auto res = action(state);
+                    if (!res.isSucceeded())
+                        continue;
+
+                    auto found = local.find(res.getState());
+                    if (found == local.end() || !found->second.closed)
+                        continue;
+
+                    int cost = node.getDepth() + res.getCost();
+                    if (cost < found->second.depth)
+                    {
+                        found->second.depth = cost;
+                        frontier.push(NPuzzleNode(found->first, cost));
+                    }
+                }
+            }
+
+            for (auto& state : closedStates)
+            {
+                auto& entry = local.at(state);
+                if (entry.depth != infinity && entry.depth > entry.heuristic)
+                {
+                    learned.set(state, entry.depth);
+                    trialUpdates++;
+                }
+            }
+        }
+    };
+}
+
+#endif
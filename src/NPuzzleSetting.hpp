@@ -5,11 +5,16 @@
 #ifndef __NPUZZLE_SETTING__
 #define __NPUZZLE_SETTING__
 
+// Could be overridden at compile time, such as -DNPUZZLE_DEMONSTRATION=15.
+#ifndef NPUZZLE_DEMONSTRATION
+#define NPUZZLE_DEMONSTRATION 8
+#endif
+
 namespace NPuzzle
 {
     //! The n-puzzle demonstration, default 8, could be change to 15, etc.
     // However, A* is too slow for 15. IDA* should be applied.
-    constexpr int demonstration = 8;
+    constexpr int demonstration = NPUZZLE_DEMONSTRATION;
     //! The cost of every operation (up, down, left, right) on the blank tile.
     constexpr int moveCost = 1;
     /**
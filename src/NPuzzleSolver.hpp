@@ -24,25 +24,109 @@ namespace NPuzzle
         unsigned long totalNodesExpanded = 0;
         unsigned long maxQueueLength = 1; // The initial state is in queue.
 
+        // All memory of a search is allocated from the arena,
+        // which is reset rather than freed node by node before the next search.
+        Arena arena;
+
+        typedef std::unordered_set<std::size_t, std::hash<std::size_t>, std::equal_to<std::size_t>,
+                                   ArenaAllocator<std::size_t>>                  VisitedSetT;
+
+        // An open-addressing table rather than an std::unordered_map, so the slot
+        // of a key is known before probing it, and could be prefetched.
+        typedef HashTable<std::size_t, int> DepthMapT;
+
+        typedef std::unordered_map<NPuzzleNode, NPuzzleNode, std::hash<NPuzzleNode>,
+                                   std::equal_to<NPuzzleNode>,
+                                   ArenaAllocator<std::pair<const NPuzzleNode, NPuzzleNode>>> ExpandMappingT;
+
         // Record visited states, use hash(state) as the key.
-        std::unordered_set<std::size_t> visitedState;
+        VisitedSetT* visitedState;
         // Heuristic function
         NPuzzleCostFunction hFunc;
+        // The heuristic function of current search, which is hFunc refined by the perimeter if used.
+        NPuzzleCostFunction searchHFunc;
+
+        // The perimeter shared with other solvers, used if it surrounds the goal state.
+        std::shared_ptr<const NPuzzlePerimeter> perimeter;
+        const NPuzzlePerimeter* activePerimeter = nullptr;
+        // The path from finalNode down the perimeter, in canonical labels.
+        std::vector<NPuzzleState> perimeterPath;
 
         // Mapping from the children node to its parent node, used in tracing path
-        std::unordered_map<NPuzzleNode, NPuzzleNode> expandMapping;
+        ExpandMappingT* expandMapping;
         // Record the final node for trace path
         NPuzzleNode finalNode;
 
+        // Relabeling tables of the goal state last search used.
+        // The search itself runs entirely on canonical labels.
+        NPuzzleGoal goal;
+
+        // Batch expansion, 0 for expanding one node at a time.
+        std::size_t batchSize = 0;
+        // How many children ahead the slots of the best depths are prefetched.
+        static constexpr std::size_t BatchPrefetchDistance = 8;
+        // The best depth each state was reached with in batch expansion, use hash(state) as the key.
+        // It is not in the arena, since growing it frees the smaller table.
+        DepthMapT bestDepth;
+        // Buffers reused across batches.
+        std::vector<bool> batchStale;
+        std::vector<std::size_t> batchHashes;
+        std::vector<std::size_t> batchSurvivors;
+        std::vector<NPuzzlePackedState> batchPacked;
+        std::vector<int> batchHeuristics;
+
+        // Enhanced Partial Expansion A*, and its table for the heuristic function.
+        bool partialExpansion = false;
+        NPuzzleOperatorSelection operatorSelection;
+
+        // Checkpoint every checkpointInterval expansions, 0 to disable.
+        std::string checkpointPath;
+        unsigned long checkpointInterval = 0;
+        unsigned long expansionsSinceCheckpoint = 0;
+        // The initial state of last search, in original labels.
+        NPuzzleState initialState;
+        // Mappings made since the last checkpoint, and the number of those written.
+        std::vector<Checkpoint::MappingRecord> pendingJournal;
+        uint64_t journalRecords = 0;
+        NPuzzleCheckpointWriter checkpointWriter;
+        std::string checkpointError;
+
+        // Make empty containers in the arena, after all memory in it is made available again.
+        // The old containers are dropped without destruction, since they own nothing but arena memory.
+        void resetContainers()
+        {
+            arena.reset();
+            visitedState = arena.create<VisitedSetT>(0, std::hash<std::size_t>(), std::equal_to<std::size_t>(),
+                                                     ArenaAllocator<std::size_t>(&arena));
+            bestDepth.clear();
+            expandMapping = arena.create<ExpandMappingT>(0, std::hash<NPuzzleNode>(),
+                                                         std::equal_to<NPuzzleNode>(),
+                                                         ArenaAllocator<NPuzzleNode>(&arena));
+        }
+
+    public:
+        NPuzzleSolver() { resetContainers(); }
+        // Containers live in the arena, so a solver could not be copied.
+        NPuzzleSolver(const NPuzzleSolver&) = delete;
+        NPuzzleSolver& operator=(const NPuzzleSolver&) = delete;
+
     public:
         //! In N-Puzzle problem, g(n) = depth.
         static int GFunc(NPuzzleNode node) { return node.getDepth(); }
+        /**
+         * \brief f(n) = g(n) + h(n), where h(n) is the one evaluated when the node was made.
+         *
+         * In Enhanced Partial Expansion A*, it is raised by NPuzzle::NPuzzleNode::getCostOffset().
+         */
+        static int FFunc(const NPuzzleNode& node) { return node.getDepth() + node.getHeuristic() + node.getCostOffset(); }
 
     public:
         //! Get the total amount of nodes expanded.
         unsigned long getTotalNodesExpanded() const { return totalNodesExpanded; }
         //! Get the max length of the search queue.
         unsigned long getMaxQueueLength() const { return maxQueueLength; }
+        //! Get the bytes of memory held for searching, which is reused by later searches.
+        std::size_t getArenaCapacity() const { return arena.getCapacity(); }
 
         //! Get the heuristic function (\c h(n)).
         NPuzzleCostFunction getHeuristicFunction() const { return hFunc; }
@@ -55,6 +139,72 @@ namespace NPuzzle
          */
         void setHeuristicFunction(NPuzzleCostFunction hFunc) { this->hFunc = hFunc; }
 
+        /**
+         * \brief Evaluate \c h(n) of a node against the goal state last search used.
+         * \param node The node in original labels, such as one in getSolutionPath().
+         * \return The heuristic cost of the node.
+         */
+        int getHeuristicCost(NPuzzleNode node) const { return hFunc(goal.relabel(node)); }
+
+        //! Get the max number of nodes expanded at a time, 0 if batch expansion is disabled.
+        std::size_t getBatchSize() const { return batchSize; }
+        /**
+         * \brief Set the max number of nodes expanded at a time.
+         * \param batchSize The max batch size, 0 to disable batch expansion.
+         *
+         * In batch expansion, nodes sharing the best \c f(n) are removed together and
+         * their children are deduplicated, evaluated and enqueued in separate passes.
+         *
+         * Unlike expanding one node at a time, a state is enqueued again if it is
+         * reached with a smaller depth, so the solution is optimal for consistent \c h(n).
+         */
+        void setBatchSize(std::size_t batchSize) { this->batchSize = batchSize; }
+
+        //! Whether Enhanced Partial Expansion A* is enabled.
+        bool isPartialExpansion() const { return partialExpansion; }
+        /**
+         * \brief Enable or disable Enhanced Partial Expansion A* (EPEA*).
+         * \param partialExpansion True to enable.
+         *
+         * In EPEA*, only children whose \c f(n) equals the one stored in their parent are
+         * generated, and the parent is enqueued again with the next larger \c f(n) of its
+         * children. Nodes that would never be expanded stay out of the queue, which shrinks
+         * it when nodes have many such children. With few children, as for Manhattan distance
+         * on the 8-puzzle, the parent enqueued again could make the queue larger. The changes of \c h(n) come from an NPuzzle::NPuzzleOperatorSelection
+         * table, so operators are selected before any child is generated. Heuristic functions
+         * without a table fall back to Partial Expansion A*, which generates and evaluates
+         * all children but still enqueues only the selected ones.
+         * Only applies when batch expansion is disabled.
+         */
+        void setPartialExpansion(bool partialExpansion) { this->partialExpansion = partialExpansion; }
+
+        /**
+         * \brief Write checkpoints periodically during later searches, see NPuzzleCheckpoint.hpp.
+         * \param path The path of the checkpoint.
+         * \param interval Write a checkpoint every \c interval expansions, 0 to disable.
+         *
+         * Checkpoints are written by a background thread while searching goes on.
+         */
+        void setCheckpoint(const std::string& path, unsigned long interval)
+        {
+            checkpointPath = path;
+            checkpointInterval = interval;
+        }
+        //! Get the error of last checkpoint written or resumed, empty if none.
+        std::string getCheckpointError() const { return checkpointError; }
+
+        //! Get the perimeter, \c nullptr if none.
+        std::shared_ptr<const NPuzzlePerimeter> getPerimeter() const { return perimeter; }
+        /**
+         * \brief Set a perimeter, which could be shared by solvers in several threads.
+         * \param perimeter The perimeter, \c nullptr to disable.
+         *
+         * Later searches toward the goal of the perimeter stop as soon as they reach it,
+         * and use its exact costs as \c h(n). The path is finished by descending the perimeter.
+         * Searches toward other goals ignore it.
+         */
+        void setPerimeter(std::shared_ptr<const NPuzzlePerimeter> perimeter) { this->perimeter = perimeter; }
+
         //! Get the path to solution if exists. The path starts with the initial state.
         std::vector<NPuzzleNode> getSolutionPath()
         {
@@ -67,14 +217,19 @@ namespace NPuzzle
             auto currentNode = finalNode;
             // The initialNode is mapped to a node with FailureDepth,
             // so it is used as the termination condition.
-            while (expandMapping[currentNode].getDepth() != NPuzzleNode::FailureDepth)
+            while ((*expandMapping)[currentNode].getDepth() != NPuzzleNode::FailureDepth)
             {
-                path.push_back(expandMapping[currentNode]);
-                currentNode = expandMapping[currentNode];
+                currentNode = (*expandMapping)[currentNode];
+                // Nodes are stored in canonical labels.
+                path.push_back(goal.restore(currentNode));
             }
 
             // The path now is in reverse order, so we reverse it back.
             std::reverse(path.begin(), path.end());
+
+            // The search stopped on the perimeter, which is descended to the goal.
+            for (std::size_t i = 0; i < perimeterPath.size(); i++)
+                path.push_back(goal.restore(NPuzzleNode(perimeterPath[i], finalNode.getDepth() + static_cast<int>(i))));
             return path;
         }
 
@@ -83,35 +238,168 @@ namespace NPuzzle
          * \param initialState The intital state.
          * \param finalState The goal state.
          * \return The SearchResult indiciates whether there is a solution.
+         *
+         * Tiles are relabeled by an NPuzzle::NPuzzleGoal so that \c finalState
+         * becomes canonical, thus the heuristic functions stay valid for any goal.
+         *
+         * If \c initialState could not reach \c finalState, the problem is rejected
+         * in O(N) rather than exhausting the reachable half of the space.
          */
         NPuzzleSearchResult solve(NPuzzleState initialState, NPuzzleState finalState)
         {
-            // Clear the information last search left.
-            visitedState.clear();
-            expandMapping.clear();
+            // Clear the information last search left, in O(1).
+            resetContainers();
             totalNodesExpanded = 0;
             maxQueueLength = 1;
+            checkpointError.clear();
+
+            // Relabel tiles so that finalState becomes the canonical goal.
+            goal = NPuzzleGoal(finalState);
+            if (!goal.isSolvable(initialState))
+            {
+                finalNode = NPuzzleNode();
+                return NPuzzleSearchResult::Rejected();
+            }
+            this->initialState = initialState;
+            initialState = goal.relabel(initialState);
+            selectHeuristic();
+
+            visitedState->insert(std::hash<NPuzzleState>()(initialState));
+            bestDepth.insert(std::hash<NPuzzleState>()(initialState), 0);
+
+            if (checkpointInterval > 0)
+                checkpointWriter.start(checkpointPath, 0);
+            journalRecords = 0;
+
+            NPuzzleNode initialNode(initialState, 0);
+            initialNode.setHeuristic(searchHFunc(initialNode));
+            return search(std::vector<NPuzzleNode>{ initialNode });
+        }
+
+        /**
+         * \brief Resume a search from a checkpoint.
+         * \param path The path of the checkpoint.
+         * \return The SearchResult indiciates whether there is a solution,
+         * or a failed one if the checkpoint could not be read, see getCheckpointError().
+         *
+         * The batch size is restored from the checkpoint. The heuristic function,
+         * whether partial expansion is enabled and the perimeter should be the same
+         * as the ones of the checkpointed search, or the checkpoint is rejected.
+         * Custom heuristic functions could not be told apart, see Checkpoint::GetHeuristicId().
+         * If checkpoints are enabled, later checkpoints are written to \c path.
+         */
+        NPuzzleSearchResult resume(const std::string& path)
+        {
+            resetContainers();
+            finalNode = NPuzzleNode();
 
-            // Constructs problem and searcher.
-            NPuzzleProblem problem(initialState, finalState);
+            NPuzzleCheckpointReader reader(path);
+            checkpointError = reader.getError();
+            if (!checkpointError.empty())
+                return NPuzzleSearchResult::Failure();
+
+            auto& header = reader.getHeader();
+            batchSize = static_cast<std::size_t>(header.batchSize);
+            totalNodesExpanded = static_cast<unsigned long>(header.totalNodesExpanded);
+            maxQueueLength = static_cast<unsigned long>(header.maxQueueLength);
+            initialState = Checkpoint::UnpackState(header.initialState);
+            goal = NPuzzleGoal(Checkpoint::UnpackState(header.finalState));
+            selectHeuristic();
+
+            // Queued nodes hold h(n) and cost offsets of the checkpointed search.
+            if (header.heuristic != static_cast<uint32_t>(Checkpoint::GetHeuristicId(hFunc)))
+                checkpointError = "Checkpoint written with another heuristic function: " + path;
+            else if ((header.partialExpansion != 0) != partialExpansion)
+                checkpointError = "Checkpoint written with partial expansion " +
+                                  std::string(partialExpansion ? "disabled: " : "enabled: ") + path;
+            else if (header.perimeterRadius != getPerimeterRadius())
+                checkpointError = "Checkpoint written with another perimeter: " + path;
+            if (!checkpointError.empty())
+                return NPuzzleSearchResult::Failure();
+
+            // Visited states and best depths are restored from the mappings.
+            auto canonicalInitial = goal.relabel(initialState);
+            visitedState->insert(std::hash<NPuzzleState>()(canonicalInitial));
+            bestDepth.insert(std::hash<NPuzzleState>()(canonicalInitial), 0);
+            auto journal = reader.getJournal();
+            for (uint64_t i = 0; i < header.journalRecords; i++)
+            {
+                auto child = journal[i].child.toNode();
+                auto hashVal = std::hash<NPuzzleState>()(child.getState());
+                (*expandMapping)[child] = journal[i].parent.toNode();
+                visitedState->insert(hashVal);
+
+                auto found = bestDepth.insert(hashVal, child.getDepth());
+                if (!found.second)
+                    *found.first = std::min(*found.first, child.getDepth());
+            }
+
+            if (checkpointInterval > 0)
+                checkpointWriter.start(path, header.journalRecords);
+            checkpointPath = path;
+            journalRecords = header.journalRecords;
+
+            std::vector<NPuzzleNode> queue;
+            for (auto& record : reader.getQueue())
+                queue.push_back(record.toNode());
+            return search(queue);
+        }
+
+    private:
+        // Use the perimeter if it surrounds the goal state of current search.
+        void selectHeuristic()
+        {
+            activePerimeter = perimeter && perimeter->getGoalState() == goal.getGoalState() ? perimeter.get() : nullptr;
+            searchHFunc = activePerimeter ? activePerimeter->refine(hFunc) : hFunc;
+        }
+
+        // The radius of the perimeter current search uses, -1 if none.
+        int32_t getPerimeterRadius() const { return activePerimeter ? activePerimeter->getRadius() : -1; }
+
+        // Search from a queue, which is in the order of a heap.
+        NPuzzleSearchResult search(const std::vector<NPuzzleNode>& queueNodes)
+        {
+            pendingJournal.clear();
+            perimeterPath.clear();
+            expansionsSinceCheckpoint = 0;
+
+            // Constructs problem and searcher. With a perimeter, reaching it passes the goal test.
+            NPuzzlePerimeterProblem problem(goal.relabel(initialState), goal.getCanonicalGoal(), activePerimeter);
             NPuzzleSearcher searcher(
                 // The depth of initial state is 0.
-                [](NPuzzleState state) -> NPuzzleNode { return NPuzzleNode(state, 0); },
+                [&](NPuzzleState state) -> NPuzzleNode {
+                    NPuzzleNode node(state, 0);
+                    node.setHeuristic(searchHFunc(node));
+                    return node;
+                },
                 [](NPuzzleNode node) -> NPuzzleState { return node.getState(); },
                 // The comparison function for the priority queue.
                 [&](const NPuzzleNode& a, const NPuzzleNode& b) {
                     // The element with less f(n) has higher priority,
                     // which actually constructs a min-heap.
                     // (The STL heap is a max-heap default)
-                    return GFunc(a) + hFunc(a) > GFunc(b) + hFunc(b);
-                }
+                    return FFunc(a) > FFunc(b);
+                },
+                ArenaAllocator<NPuzzleNode>(&arena)
             );
 
-            visitedState.insert(std::hash<NPuzzleState>()(initialState));
-            auto result = searcher.generalSearch(&problem,
+            if (partialExpansion)
+                operatorSelection = NPuzzleOperatorSelection::ForHeuristic(searchHFunc);
+
+            auto nodes = searcher.makeQueue();
+            nodes.assign(queueNodes.begin(), queueNodes.end());
+
+            auto result = batchSize > 0 ? searcher.batchSearch(&problem,
+                [&](NPuzzleQueue& queue, const NPuzzleExpandBatchResult& expand)
+                {
+                    queueBatch(queue, expand);
+                }, batchSize, nodes) : searcher.generalSearch(&problem,
                 // Queuing-Function
                 [&](NPuzzleQueue& queue, NPuzzleExpandResult expand)
                 {
+                    if (partialExpansion)
+                        return queuePartially(queue, expand);
+
                     auto currentNode = expand.getCurrentNode();
                    
                     for (auto expRes : expand.getResult())
@@ -122,18 +410,19 @@ namespace NPuzzle
                         auto hashVal = std::hash<NPuzzleState>()(nextState);
 
                         // Has this expanded state visited?
-                        if (visitedState.find(hashVal) != visitedState.end())
+                        if (visitedState->find(hashVal) != visitedState->end())
                             continue;
 
                         // Enqueue a new node with expanded nextState and depth + 1
                         auto newNode = NPuzzleNode(nextState, currentNode.getDepth() + 1);
+                        newNode.setHeuristic(searchHFunc(newNode));
                         queue.push(newNode);
                         // Mapping the new node to its parent node.
-                        expandMapping[newNode] = currentNode;
+                        mapToParent(newNode, currentNode);
     
                         // Update associated fields
                         totalNodesExpanded++;
-                        visitedState.insert(hashVal);
+                        visitedState->insert(hashVal);
 
                         // Check if nextState goal
                         if (problem.goalTest(nextState))
@@ -143,12 +432,240 @@ namespace NPuzzle
                     // Is the size of current queue larger than previous?
                     if (queue.size() > maxQueueLength)
                         maxQueueLength = queue.size();
-                }
-            );
+
+                    checkpointIfDue(queue);
+                },
+                // Operator selection of EPEA*, if the heuristic function has a table.
+                partialExpansion && operatorSelection.isAvailable()
+                    ? NPuzzleSearcher::OperatorSelectionT([&](const NPuzzleNode& node) { return selectPartially(node); })
+                    : nullptr,
+                nodes);
+
+            if (checkpointInterval > 0)
+            {
+                auto error = checkpointWriter.getError();
+                if (!error.empty())
+                    checkpointError = error;
+            }
 
             // Set finalNode for later path tracing
             finalNode = result.getFinalNode();
-            return result;
+            if (!result.isSucceeded())
+                return result;
+            if (activePerimeter)
+            {
+                perimeterPath = activePerimeter->descend(finalNode.getState());
+                int depth = finalNode.getDepth() + static_cast<int>(perimeterPath.size());
+                return NPuzzleSearchResult::Success(NPuzzleNode(goal.getGoalState(), depth));
+            }
+            return NPuzzleSearchResult::Success(goal.restore(finalNode));
+        }
+
+        void mapToParent(const NPuzzleNode& node, const NPuzzleNode& parent)
+        {
+            (*expandMapping)[node] = parent;
+            if (checkpointInterval > 0)
+                pendingJournal.push_back(Checkpoint::MappingRecord{
+                    Checkpoint::NodeRecord::FromNode(node), Checkpoint::NodeRecord::FromNode(parent) });
+        }
+
+        // Hand a checkpoint to the writer, if enough nodes were expanded since the last one.
+        void checkpointIfDue(const NPuzzleQueue& queue)
+        {
+            if (checkpointInterval == 0 || ++expansionsSinceCheckpoint < checkpointInterval)
+                return;
+            expansionsSinceCheckpoint = 0;
+
+            auto header = Checkpoint::Header();
+            std::copy(Checkpoint::Magic, Checkpoint::Magic + sizeof(Checkpoint::Magic), header.magic);
+            header.puzzleSize = demonstration;
+            header.nodeRecordSize = sizeof(Checkpoint::NodeRecord);
+            header.heuristic = static_cast<uint32_t>(Checkpoint::GetHeuristicId(hFunc));
+            header.partialExpansion = partialExpansion ? 1 : 0;
+            header.perimeterRadius = getPerimeterRadius();
+            header.batchSize = batchSize;
+            header.totalNodesExpanded = totalNodesExpanded;
+            header.maxQueueLength = maxQueueLength;
+            header.journalRecords = journalRecords + pendingJournal.size();
+            header.queueSize = queue.size();
+            Checkpoint::PackState(initialState, header.initialState);
+            Checkpoint::PackState(goal.getGoalState(), header.finalState);
+
+            // Only copying the queue pauses the search.
+            std::vector<Checkpoint::NodeRecord> queueRecords;
+            queueRecords.reserve(queue.size());
+            for (auto& node : queue.getContainer())
+                queueRecords.push_back(Checkpoint::NodeRecord::FromNode(node));
+
+            journalRecords = header.journalRecords;
+            checkpointWriter.write(header, std::move(queueRecords), std::move(pendingJournal));
+            pendingJournal.clear();
+        }
+
+        // Operator selection of EPEA*. Select the moves whose child has f(n) equal to the one
+        // stored in the node, along with the next larger f(n) of the others.
+        NPuzzleSearcher::OperatorSelection selectPartially(const NPuzzleNode& node) const
+        {
+            auto& state = node.getState();
+            int storedF = FFunc(node);
+            // f(n) of a child is g(n) + 1 + h(n) + delta, where h(n) is the one of the node.
+            int childBase = node.getDepth() + moveCost + node.getHeuristic();
+            int nextF = std::numeric_limits<int>::max();
+
+            int row, col;
+            int blank = static_cast<int>(std::find(state.begin(), state.end(), 0) - state.begin());
+            indexToMatrix(blank, row, col);
+
+            // In the order of the operators of NPuzzle::NPuzzleProblem: left, right, up and down.
+            const int moves[4][2] = { { 0, -1 }, { 0, 1 }, { -1, 0 }, { 1, 0 } };
+            NPuzzleSearcher::OperatorMaskT selected = 0;
+            for (int i = 0; i < 4; i++)
+            {
+                int nextRow = row + moves[i][0], nextCol = col + moves[i][1];
+                if (nextRow < 0 || nextRow >= matrixDemonstration || nextCol < 0 || nextCol >= matrixDemonstration)
+                    continue;
+
+                // The tile there moves into the blank.
+                int from = matrixToIndex(nextRow, nextCol);
+                int f = childBase + operatorSelection.getDelta(state[from], from, blank);
+                // Children with smaller f(n) were generated by earlier expansions of the node.
+                if (f == storedF)
+                    selected |= 1u << i;
+                else if (f > storedF)
+                    nextF = std::min(nextF, f);
+            }
+            return NPuzzleSearcher::OperatorSelection{ selected, nextF };
+        }
+
+        // Queuing-Function of EPEA*. The f(n) stored in a queued node is F(n), the f(n) of
+        // children to be enqueued when it is removed, kept as an offset above g(n) + h(n).
+        void queuePartially(NPuzzleQueue& queue, const NPuzzleExpandResult& expand)
+        {
+            auto currentNode = expand.getCurrentNode();
+            int storedF = FFunc(currentNode);
+            int depth = currentNode.getDepth() + 1;
+            bool selected = operatorSelection.isAvailable();
+            int nextF = expand.getNextCost();
+
+            for (auto& expRes : expand.getResult())
+            {
+                auto& nextState = expRes.first;
+
+                // Selected children have f(n) = F(n), or else h(n) is evaluated to filter them.
+                int h = storedF - depth;
+                if (!selected)
+                {
+                    h = searchHFunc(NPuzzleNode(nextState, depth));
+                    // Children with larger f(n) wait for the parent to be enqueued again.
+                    if (depth + h > storedF)
+                    {
+                        nextF = std::min(nextF, depth + h);
+                        continue;
+                    }
+                }
+
+                auto hashVal = std::hash<NPuzzleState>()(nextState);
+                if (visitedState->find(hashVal) != visitedState->end())
+                    continue;
+
+                auto newNode = NPuzzleNode(nextState, depth, h);
+                queue.push(newNode);
+                mapToParent(newNode, currentNode);
+
+                totalNodesExpanded++;
+                visitedState->insert(hashVal);
+            }
+
+            // Enqueue the parent again with the next f(n) of its children.
+            if (nextF != std::numeric_limits<int>::max())
+            {
+                currentNode.setCostOffset(nextF - currentNode.getDepth() - currentNode.getHeuristic());
+                queue.push(currentNode);
+            }
+
+            // Is the size of current queue larger than previous?
+            if (queue.size() > maxQueueLength)
+                maxQueueLength = queue.size();
+
+            checkpointIfDue(queue);
+        }
+
+        // Queuing-Function for a batch, each pass runs over all children at once.
+        void queueBatch(NPuzzleQueue& queue, const NPuzzleExpandBatchResult& expand)
+        {
+            const auto& results = expand.getResult();
+            const auto& nodes = expand.getNodes();
+
+            // Pass 1: skip nodes already reached with a smaller depth after being enqueued.
+            batchStale.resize(nodes.size());
+            for (std::size_t i = 0; i < nodes.size(); i++)
+            {
+                auto best = bestDepth.find(std::hash<NPuzzleState>()(nodes[i].getState()));
+                batchStale[i] = best && nodes[i].getDepth() > *best;
+            }
+
+            // Pass 2: hash all children.
+            batchHashes.resize(results.size());
+            for (std::size_t i = 0; i < results.size(); i++)
+                batchHashes[i] = std::hash<NPuzzleState>()(results[i].first);
+
+            // Pass 3: duplicate detection, which also removes duplicates within the batch.
+            // Slots a few children ahead are prefetched, so their cache misses overlap.
+            batchSurvivors.clear();
+            for (std::size_t i = 0; i < BatchPrefetchDistance && i < results.size(); i++)
+                bestDepth.prefetch(batchHashes[i]);
+            for (std::size_t i = 0; i < results.size(); i++)
+            {
+                if (i + BatchPrefetchDistance < results.size())
+                    bestDepth.prefetch(batchHashes[i + BatchPrefetchDistance]);
+
+                auto parentIndex = expand.getParentIndex(i);
+                if (batchStale[parentIndex])
+                    continue;
+
+                int depth = nodes[parentIndex].getDepth() + 1;
+                auto found = bestDepth.insert(batchHashes[i], depth);
+                if (!found.second)
+                {
+                    if (*found.first <= depth)
+                        continue;
+                    *found.first = depth;
+                }
+                batchSurvivors.push_back(i);
+            }
+
+            // Pass 4: evaluate h(n) of survivors, using the vectorized kernel if possible.
+            batchHeuristics.resize(batchSurvivors.size());
+            auto kernel = GetBatchKernel(searchHFunc);
+            if (kernel)
+            {
+                batchPacked.resize(batchSurvivors.size());
+                for (std::size_t i = 0; i < batchSurvivors.size(); i++)
+                    batchPacked[i] = packState(results[batchSurvivors[i]].first);
+                kernel(batchPacked.data(), batchHeuristics.data(), batchPacked.size());
+            }
+            else
+            {
+                for (std::size_t i = 0; i < batchSurvivors.size(); i++)
+                    batchHeuristics[i] = searchHFunc(NPuzzleNode(results[batchSurvivors[i]].first, 0));
+            }
+
+            // Pass 5: enqueue survivors and map them to their parents.
+            for (std::size_t i = 0; i < batchSurvivors.size(); i++)
+            {
+                auto index = batchSurvivors[i];
+                const auto& parent = nodes[expand.getParentIndex(index)];
+                auto newNode = NPuzzleNode(results[index].first, parent.getDepth() + 1, batchHeuristics[i]);
+                queue.push(newNode);
+                mapToParent(newNode, parent);
+            }
+            totalNodesExpanded += batchSurvivors.size();
+
+            // Is the size of current queue larger than previous?
+            if (queue.size() > maxQueueLength)
+                maxQueueLength = queue.size();
+
+            checkpointIfDue(queue);
         }
     };
 }
@@ -0,0 +1,280 @@
+/**
+ * \file NPuzzleStaticSolver.hpp
+ * \brief The solver for N-Puzzle problem on StaticSearcher, with the heuristic function
+ * known at compile time.
+ *
+ * It expands the same nodes in the same order as NPuzzle::NPuzzleSolver expanding one
+ * node at a time, without calls through \c std::function or virtual functions.
+ */
+#ifndef __NPUZZLE_STATIC_SOLVER__
+#define __NPUZZLE_STATIC_SOLVER__
+
+namespace NPuzzle
+{
+    /**
+     * \brief The N-Puzzle problem as a problem policy of StaticSearcher.
+     *
+     * Successors are visited in the order of the operators of NPuzzle::NPuzzleProblem,
+     * that is \c left, \c right, \c up and \c down.
+     */
+    class NPuzzleStaticProblem
+    {
+    public:
+        typedef NPuzzleState StateT;
+        typedef int          ExpandCostT;
+
+        //! At most 4 moves from a state.
+        static constexpr std::size_t MaxSuccessors = 4;
+
+    private:
+        NPuzzleState initialState;
+        std::size_t finalHash;
+
+    public:
+        /**
+         * \param initialState The initial state.
+         * \param finalState The final state.
+         */
+        NPuzzleStaticProblem(NPuzzleState initialState, NPuzzleState finalState)
+            : initialState(initialState), finalHash(std::hash<NPuzzleState>()(finalState)) {}
+
+        //! Get the initial state.
+        NPuzzleState getInitialState() const { return initialState; }
+
+        //! Test by hash, as NPuzzle::NPuzzleProblem::goalTest() does.
+        bool goalTest(const NPuzzleState& state) const { return std::hash<NPuzzleState>()(state) == finalHash; }
+
+        //! Call \c visit(nextState, moveCost) for each move of the blank.
+        template <class VisitorT>
+        void forEachSuccessor(const NPuzzleState& state, VisitorT&& visit) const
+        {
+            int row, col;
+            long blank = std::find(state.begin(), state.end(), 0) - state.begin();
+            indexToMatrix(blank, row, col);
+
+            if (col - 1 >= 0)
+                visitMove(state, blank, matrixToIndex(row, col - 1), visit);
+            if (col + 1 < matrixDemonstration)
+                visitMove(state, blank, matrixToIndex(row, col + 1), visit);
+            if (row - 1 >= 0)
+                visitMove(state, blank, matrixToIndex(row - 1, col), visit);
+            if (row + 1 < matrixDemonstration)
+                visitMove(state, blank, matrixToIndex(row + 1, col), visit);
+        }
+
+    private:
+        template <class VisitorT>
+        static void visitMove(const NPuzzleState& state, long blank, long target, VisitorT& visit)
+        {
+            NPuzzleState next = state;
+            std::swap(next[blank], next[target]);
+            visit(next, moveCost);
+        }
+    };
+
+    /**
+     * \brief A heuristic function as a type, so that calls to it could be inlined.
+     * \tparam HFunc The heuristic function, such as NPuzzle::GetManhattanDistance.
+     */
+    template <int (*HFunc)(NPuzzleNode)>
+    struct NPuzzleStaticHeuristic
+    {
+        int operator()(const NPuzzleNode& node) const { return HFunc(node); }
+    };
+
+    /**
+     * \brief The node policy of StaticSearcher, making NPuzzle::NPuzzleNode with \c h(n) evaluated.
+     * \tparam HeuristicT The heuristic function type, such as NPuzzle::NPuzzleStaticHeuristic.
+     */
+    template <class HeuristicT>
+    class NPuzzleStaticNodePolicy
+    {
+    public:
+        typedef NPuzzleNode NodeT;
+
+    private:
+        HeuristicT heuristic;
+
+    public:
+        explicit NPuzzleStaticNodePolicy(HeuristicT heuristic = HeuristicT()) : heuristic(heuristic) {}
+
+        //! Make a node of a state at a depth, 0 for the initial state.
+        NPuzzleNode makeNode(const NPuzzleState& state, int depth = 0) const
+        {
+            NPuzzleNode node(state, depth);
+            node.setHeuristic(heuristic(node));
+            return node;
+        }
+
+        //! Get the state of a node, without copying it.
+        const NPuzzleState& toState(const NPuzzleNode& node) const { return node.getState(); }
+    };
+
+    //! The comparator of NPuzzle::NPuzzleSolver as a type, putting the node with less \c f(n) on top.
+    struct NPuzzleFComparator
+    {
+        bool operator()(const NPuzzleNode& a, const NPuzzleNode& b) const
+        {
+            return NPuzzleSolver::FFunc(a) > NPuzzleSolver::FFunc(b);
+        }
+    };
+
+    //! The priority queue of NPuzzle::NPuzzleStaticSolver.
+    typedef StaticPriorityQueue<NPuzzleNode, NPuzzleFComparator, ArenaAllocator<NPuzzleNode>> NPuzzleStaticQueue;
+
+    /**
+     * \brief The solver for N-Puzzle problem, with policies resolved at compile time.
+     * \tparam HeuristicT The heuristic function type, such as
+     * <tt>NPuzzleStaticHeuristic<GetManhattanDistance></tt>.
+     *
+     * It searches as NPuzzle::NPuzzleSolver does with neither batch expansion,
+     * partial expansion, checkpoints nor a perimeter, so both return the same
+     * result, path, node counts and queue length. The heuristic function is fixed
+     * by the type, and the problem, the queue and the queuing function are bound
+     * at compile time rather than through \c std::function.
+     */
+    template <class HeuristicT>
+    class NPuzzleStaticSolver
+        : public StaticSearcher<NPuzzleStaticSolver<HeuristicT>, NPuzzleStaticProblem,
+                                NPuzzleStaticNodePolicy<HeuristicT>, NPuzzleStaticQueue>
+    {
+    private:
+        typedef StaticSearcher<NPuzzleStaticSolver<HeuristicT>, NPuzzleStaticProblem,
+                               NPuzzleStaticNodePolicy<HeuristicT>, NPuzzleStaticQueue> SearcherT;
+        // The searcher calls the queuing function.
+        friend SearcherT;
+
+        typedef std::unordered_set<std::size_t, std::hash<std::size_t>, std::equal_to<std::size_t>,
+                                   ArenaAllocator<std::size_t>>                  VisitedSetT;
+        typedef std::unordered_map<NPuzzleState, NPuzzleNode, std::hash<NPuzzleState>,
+                                   std::equal_to<NPuzzleState>,
+                                   ArenaAllocator<std::pair<const NPuzzleState, NPuzzleNode>>> ExpandMappingT;
+
+        // Statistic
+        unsigned long totalNodesExpanded = 0;
+        unsigned long maxQueueLength = 1; // The initial state is in queue.
+
+        // All memory of a search is allocated from the arena, as NPuzzle::NPuzzleSolver does.
+        Arena arena;
+        // Record visited states, use hash(state) as the key.
+        VisitedSetT* visitedState;
+        // Mapping from the state of a child to its parent node, used in tracing path.
+        ExpandMappingT* expandMapping;
+        // The problem of current search.
+        const NPuzzleStaticProblem* problem = nullptr;
+        // Record the final node for trace path.
+        NPuzzleNode finalNode;
+
+        // Relabeling tables of the goal state last search used.
+        NPuzzleGoal goal;
+
+        void resetContainers()
+        {
+            arena.reset();
+            visitedState = arena.create<VisitedSetT>(0, std::hash<std::size_t>(), std::equal_to<std::size_t>(),
+                                                     ArenaAllocator<std::size_t>(&arena));
+            expandMapping = arena.create<ExpandMappingT>(0, std::hash<NPuzzleState>(),
+                                                         std::equal_to<NPuzzleState>(),
+                                                         ArenaAllocator<NPuzzleNode>(&arena));
+        }
+
+    public:
+        explicit NPuzzleStaticSolver(HeuristicT heuristic = HeuristicT())
+            : SearcherT(NPuzzleStaticNodePolicy<HeuristicT>(heuristic))
+        {
+            resetContainers();
+        }
+        // Containers live in the arena, so a solver could not be copied.
+        NPuzzleStaticSolver(const NPuzzleStaticSolver&) = delete;
+        NPuzzleStaticSolver& operator=(const NPuzzleStaticSolver&) = delete;
+
+        //! Get the total amount of nodes expanded.
+        unsigned long getTotalNodesExpanded() const { return totalNodesExpanded; }
+        //! Get the max length of the search queue.
+        unsigned long getMaxQueueLength() const { return maxQueueLength; }
+
+        //! Get the path to solution if exists. The path starts with the initial state.
+        std::vector<NPuzzleNode> getSolutionPath() const
+        {
+            std::vector<NPuzzleNode> path;
+            if (finalNode.getDepth() == NPuzzleNode::FailureDepth)
+                return path;
+
+            // The initial state has no parent, which terminates the trace.
+            auto parent = expandMapping->find(finalNode.getState());
+            while (parent != expandMapping->end())
+            {
+                path.push_back(goal.restore(parent->second));
+                parent = expandMapping->find(parent->second.getState());
+            }
+
+            std::reverse(path.begin(), path.end());
+            return path;
+        }
+
+        /**
+         * \brief Solve the N-Puzzle problem based on a initial state.
+         * \param initialState The intital state.
+         * \param finalState The goal state.
+         * \return The SearchResult indiciates whether there is a solution.
+         *
+         * \see NPuzzle::NPuzzleSolver::solve()
+         */
+        NPuzzleSearchResult solve(NPuzzleState initialState, NPuzzleState finalState)
+        {
+            resetContainers();
+            totalNodesExpanded = 0;
+            maxQueueLength = 1;
+
+            goal = NPuzzleGoal(finalState);
+            if (!goal.isSolvable(initialState))
+            {
+                finalNode = NPuzzleNode();
+                return NPuzzleSearchResult::Rejected();
+            }
+            initialState = goal.relabel(initialState);
+            visitedState->insert(std::hash<NPuzzleState>()(initialState));
+
+            NPuzzleStaticProblem searchProblem(initialState, goal.getCanonicalGoal());
+            problem = &searchProblem;
+            NPuzzleStaticQueue nodes{ NPuzzleFComparator(), ArenaAllocator<NPuzzleNode>(&arena) };
+            auto result = this->generalSearch(searchProblem, nodes);
+            problem = nullptr;
+
+            finalNode = result.getFinalNode();
+            if (!result.isSucceeded())
+                return result;
+            return NPuzzleSearchResult::Success(goal.restore(finalNode));
+        }
+
+    private:
+        // Queuing-Function
+        void queue(NPuzzleStaticQueue& nodes, const typename SearcherT::ExpandResultT& expand)
+        {
+            auto& currentNode = expand.getCurrentNode();
+            for (auto& expRes : expand)
+            {
+                auto& nextState = expRes.first;
+                auto hashVal = std::hash<NPuzzleState>()(nextState);
+
+                // Has this expanded state visited?
+                if (!visitedState->insert(hashVal).second)
+                    continue;
+
+                auto newNode = this->nodePolicy.makeNode(nextState, currentNode.getDepth() + expRes.second);
+                nodes.push(newNode);
+                // Mapping the new node to its parent node.
+                (*expandMapping)[nextState] = currentNode;
+                totalNodesExpanded++;
+
+                if (problem->goalTest(nextState))
+                    break;
+            }
+
+            if (nodes.size() > maxQueueLength)
+                maxQueueLength = nodes.size();
+        }
+    };
+}
+
+#endif
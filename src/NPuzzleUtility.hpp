@@ -43,29 +43,86 @@ namespace NPuzzle
         return count;
     }
 
-    //! Helper function for checking solvability.
-    bool isSolvable(NPuzzleState state)
+    //! Whether a state contains each of 0, 1, ..., demonstration exactly once.
+    bool isPermutation(NPuzzleState state)
     {
-        if (matrixDemonstration % 2)
+        std::array<bool, demonstration + 1> seen;
+        seen.fill(false);
+        for (auto tile : state)
         {
-            // If the grid width is odd, the number of inversions in solvable
-            // state should be even.
-            return countInversions(state) % 2 == 0;
+            if (tile < 0 || tile > demonstration || seen[tile])
+                return false;
+            seen[tile] = true;
         }
-        else
+        return true;
+    }
+
+    /**
+     * \brief Get the parity of a permutation by cycle decomposition in O(N).
+     * \param target The permutation, which maps position \c i to <tt>target[i]</tt>.
+     * \return 0 if the permutation is even, 1 if odd.
+     *
+     * A cycle of length \c k is made of <tt>k - 1</tt> transpositions.
+     */
+    int permutationParity(NPuzzleState target)
+    {
+        std::array<bool, demonstration + 1> visited;
+        visited.fill(false);
+
+        int transpositions = 0;
+        for (int i = 0; i <= demonstration; i++)
         {
-            // For a even grid, if the blank on an even row counting from the bottom,
-            // then the number of inversions in solvable state should be odd.
-            // Otherwise, if the blank on an odd row, the number of inversions should be even.
-            int row, col;
-            auto blank = std::find(state.begin(), state.end(), 0) - state.begin();
-            indexToMatrix(blank, row, col);
-
-            if ((matrixDemonstration - row) % 2 == 0)   // even blank
-                return countInversions(state) % 2 != 0; // odd inversions
-            else                                        // odd blank
-                return countInversions(state) % 2 == 0; // even inversions
+            if (visited[i])
+                continue;
+            for (int j = i; !visited[j]; j = target[j])
+            {
+                visited[j] = true;
+                transpositions++;
+            }
+            transpositions--;
         }
+        return transpositions % 2;
+    }
+
+    /**
+     * \brief Helper function for checking solvability under a goal state in O(N).
+     * \param state The state to be checked.
+     * \param goal The goal state.
+     *
+     * Every move swaps the blank with a tile, and moves the blank by one step.
+     * So a state is solvable if and only if the permutation from \c state to \c goal
+     * has the same parity as the Manhattan distance between their blanks.
+     */
+    bool isSolvable(NPuzzleState state, NPuzzleState goal)
+    {
+        if (!isPermutation(state) || !isPermutation(goal))
+            return false;
+
+        // Goal position of each tile.
+        std::array<int, demonstration + 1> position;
+        for (int i = 0; i <= demonstration; i++)
+            position[goal[i]] = i;
+
+        NPuzzleState target;
+        for (int i = 0; i <= demonstration; i++)
+            target[i] = position[state[i]];
+
+        int row, col, goalRow, goalCol;
+        indexToMatrix(std::find(state.begin(), state.end(), 0) - state.begin(), row, col);
+        indexToMatrix(position[0], goalRow, goalCol);
+        int blankDistance = abs(row - goalRow) + abs(col - goalCol);
+
+        return permutationParity(target) == blankDistance % 2;
+    }
+
+    //! Helper function for checking solvability under the default goal state.
+    bool isSolvable(NPuzzleState state)
+    {
+        NPuzzleState goal;
+        for (int i = 0; i < demonstration; i++)
+            goal[i] = i + 1;
+        goal[demonstration] = 0;
+        return isSolvable(state, goal);
     }
 }
 
@@ -8,6 +8,7 @@
 /**
  * \brief A priority queue based on \c std::vector, using STL heap to maintain it.
  * \tparam ValueT The value type to be used in queue.
+ * \tparam AllocatorT The allocator used by the underlying container.
  *
  * Supports changing comparison function dynamically,
  * which is not supported by the STL version.
@@ -15,12 +16,12 @@
  * It actually constructs a min-heap rather than
  * a max-heap that STL version does.
  */
-template <class ValueT>
+template <class ValueT, class AllocatorT = std::allocator<ValueT>>
 class PriorityQueue
 {
 public:
     //! Use a \c std::vector as the underlying container
-    typedef std::vector<ValueT>                               ContainerT;
+    typedef std::vector<ValueT, AllocatorT>                   ContainerT;
     typedef typename ContainerT::const_reference              ConstRefT;
     typedef typename ContainerT::size_type                    SizeT;
     /**
@@ -51,6 +52,13 @@ public:
      * \param comparator The custom comparator.
      */
     PriorityQueue(ComparatorT comparator) : comparator(comparator) {}
+    /**
+     * \brief Create a priority queue with custom comparator and allocator.
+     * \param comparator The custom comparator.
+     * \param allocator The allocator used by the underlying container.
+     */
+    PriorityQueue(ComparatorT comparator, const AllocatorT& allocator)
+        : container(allocator), comparator(comparator) {}
 
     //! Set the comparator.
     void setComparator(ComparatorT comparator) { this->comparator = comparator; }
@@ -66,6 +74,8 @@ public:
     SizeT size() const { return container.size(); }
     //! Get the top element.
     ConstRefT top() const { return container.front(); }
+    //! Get all elements, in the order of the underlying heap.
+    const ContainerT& getContainer() const { return container; }
 
     /**
      * \brief Push an element into queue.
@@ -77,6 +87,18 @@ public:
         std::push_heap(container.begin(), container.end(), comparator);
     }
 
+    /**
+     * \brief Replace all elements, which should already be in the order of a heap.
+     * \param first The first element, such as one from getContainer() of another queue.
+     * \param last The element after the last one.
+     */
+    template <class IteratorT>
+    void assign(IteratorT first, IteratorT last)
+    {
+        // Rebuilding the heap could reorder equal elements, so the order is kept as is.
+        container.assign(first, last);
+    }
+
     //! Pop the top element from the queue.
     void pop()
     {
@@ -0,0 +1,248 @@
+/**
+ * \file StaticSearch.hpp
+ * \brief The compile-time variant of the general searcher in GeneralSearch.hpp.
+ *
+ * The problem, the node and the queue are policies given as template parameters,
+ * and the queuing function is a member of the derived searcher (CRTP). Nothing is
+ * virtual or a \c std::function, so the whole search could be inlined.
+ *
+ * Policies are checked by \c static_assert, see the traits in \c StaticSearchConcept.
+ */
+#ifndef __STATIC_SEARCH__
+#define __STATIC_SEARCH__
+
+/**
+ * \brief Traits checking the policies of StaticSearcher, standing in for concepts.
+ */
+namespace StaticSearchConcept
+{
+    template <class...>
+    struct Void { typedef void type; };
+
+    // A visitor of successors, only used in unevaluated checks.
+    template <class StateT, class ExpandCostT>
+    struct SuccessorVisitor { void operator()(const StateT&, ExpandCostT) const {} };
+
+    /**
+     * \brief Whether \c ProblemT is a problem policy, which should have:
+     * \code
+     * typedef ... StateT;
+     * typedef ... ExpandCostT;
+     * static constexpr std::size_t MaxSuccessors = ...;
+     * StateT getInitialState() const;
+     * bool goalTest(const StateT& state) const;
+     * // Call visit(nextState, cost) for each successor, in the order of operators.
+     * template <class VisitorT> void forEachSuccessor(const StateT& state, VisitorT&& visit) const;
+     * \endcode
+     */
+    template <class ProblemT, class = void>
+    struct IsProblem : std::false_type {};
+
+    template <class ProblemT>
+    struct IsProblem<ProblemT, typename Void<
+        typename ProblemT::StateT,
+        typename ProblemT::ExpandCostT,
+        decltype(std::integral_constant<std::size_t, ProblemT::MaxSuccessors>()),
+        decltype(std::declval<const ProblemT&>().getInitialState()),
+        decltype(static_cast<bool>(std::declval<const ProblemT&>().goalTest(
+            std::declval<const typename ProblemT::StateT&>()))),
+        decltype(std::declval<const ProblemT&>().forEachSuccessor(
+            std::declval<const typename ProblemT::StateT&>(),
+            SuccessorVisitor<typename ProblemT::StateT, typename ProblemT::ExpandCostT>()))
+    >::type> : std::true_type {};
+
+    /**
+     * \brief Whether \c NodePolicyT is a node policy for states of \c StateT, which should have:
+     * \code
+     * typedef ... NodeT;
+     * NodeT makeNode(const StateT& state) const;
+     * StateT toState(const NodeT& node) const; // or a reference to it
+     * \endcode
+     */
+    template <class NodePolicyT, class StateT, class = void>
+    struct IsNodePolicy : std::false_type {};
+
+    template <class NodePolicyT, class StateT>
+    struct IsNodePolicy<NodePolicyT, StateT, typename Void<
+        typename NodePolicyT::NodeT,
+        typename std::enable_if<std::is_convertible<
+            decltype(std::declval<const NodePolicyT&>().makeNode(std::declval<const StateT&>())),
+            typename NodePolicyT::NodeT>::value>::type,
+        typename std::enable_if<std::is_convertible<
+            decltype(std::declval<const NodePolicyT&>().toState(std::declval<const typename NodePolicyT::NodeT&>())),
+            StateT>::value>::type
+    >::type> : std::true_type {};
+
+    /**
+     * \brief Whether \c QueueT is a queue of \c NodeT, which should have:
+     * \code
+     * void push(const NodeT& node);
+     * const NodeT& top() const; // or a copy
+     * void pop();
+     * bool isEmpty() const;
+     * \endcode
+     */
+    template <class QueueT, class NodeT, class = void>
+    struct IsQueue : std::false_type {};
+
+    template <class QueueT, class NodeT>
+    struct IsQueue<QueueT, NodeT, typename Void<
+        decltype(std::declval<QueueT&>().push(std::declval<const NodeT&>())),
+        decltype(std::declval<QueueT&>().pop()),
+        typename std::enable_if<std::is_convertible<decltype(std::declval<const QueueT&>().top()), NodeT>::value>::type,
+        decltype(static_cast<bool>(std::declval<const QueueT&>().isEmpty()))
+    >::type> : std::true_type {};
+}
+
+/**
+ * \brief A priority queue like PriorityQueue, but the comparator is a type.
+ * \tparam ValueT The value type to be used in queue.
+ * \tparam CompareT The comparator type, \c CompareT()(a, b) is true if \c b comes first.
+ * \tparam AllocatorT The allocator used by the underlying container.
+ *
+ * It runs the same STL heap operations as PriorityQueue, so both remove
+ * elements in the same order given the same comparison.
+ */
+template <class ValueT, class CompareT, class AllocatorT = std::allocator<ValueT>>
+class StaticPriorityQueue
+{
+public:
+    typedef std::vector<ValueT, AllocatorT> ContainerT;
+    typedef typename ContainerT::size_type  SizeT;
+
+private:
+    ContainerT container;
+    CompareT comparator;
+
+public:
+    explicit StaticPriorityQueue(CompareT comparator = CompareT(), const AllocatorT& allocator = AllocatorT())
+        : container(allocator), comparator(comparator) {}
+
+    //! Get the top element.
+    const ValueT& top() const { return container.front(); }
+    //! Push an element into the queue.
+    void push(const ValueT& value)
+    {
+        container.push_back(value);
+        std::push_heap(container.begin(), container.end(), comparator);
+    }
+    //! Pop the top element from the queue.
+    void pop()
+    {
+        std::pop_heap(container.begin(), container.end(), comparator);
+        container.pop_back();
+    }
+    //! Whether the queue is empty.
+    bool isEmpty() const { return container.empty(); }
+    //! Get the size of the queue.
+    SizeT size() const { return container.size(); }
+    //! Get the comparator.
+    const CompareT& getComparator() const { return comparator; }
+};
+
+/**
+ * \brief The states expanded from a node, stored in place.
+ * \tparam StateT The state type.
+ * \tparam NodeT The node type.
+ * \tparam ExpandCostT The expanding cost type.
+ * \tparam MaxSuccessors The max number of states expanded from a node.
+ */
+template <class StateT, class NodeT, class ExpandCostT, std::size_t MaxSuccessors>
+class StaticExpandResult
+{
+public:
+    typedef std::pair<StateT, ExpandCostT> ResultPairT;
+
+private:
+    NodeT currentNode;
+    ResultPairT result[MaxSuccessors];
+    std::size_t count = 0;
+
+public:
+    explicit StaticExpandResult(const NodeT& expandedNode) : currentNode(expandedNode) {}
+
+    //! Add a state expanded from the node.
+    void add(const StateT& state, ExpandCostT cost) { result[count++] = ResultPairT(state, cost); }
+
+    //! Get the expanded node.
+    const NodeT& getCurrentNode() const { return currentNode; }
+    //! Get the first state expanded and its cost.
+    const ResultPairT* begin() const { return result; }
+    //! Get the end of states expanded.
+    const ResultPairT* end() const { return result + count; }
+    //! Get the number of states expanded.
+    std::size_t size() const { return count; }
+};
+
+/**
+ * \brief The general searcher, with policies resolved at compile time.
+ * \tparam DerivedT The derived searcher, which should have the queuing function:
+ * \code
+ * void queue(QueueT& queue, const ExpandResultT& result);
+ * \endcode
+ * \tparam ProblemT The problem policy, see StaticSearchConcept::IsProblem.
+ * \tparam NodePolicyT The node policy, see StaticSearchConcept::IsNodePolicy.
+ * \tparam QueueT The queue, see StaticSearchConcept::IsQueue.
+ *
+ * It follows the same general search as GeneralSearcher::generalSearch().
+ */
+template <class DerivedT, class ProblemT, class NodePolicyT, class QueueT>
+class StaticSearcher
+{
+    static_assert(StaticSearchConcept::IsProblem<ProblemT>::value,
+                  "ProblemT should be a problem policy, see StaticSearchConcept::IsProblem.");
+    static_assert(StaticSearchConcept::IsNodePolicy<NodePolicyT, typename ProblemT::StateT>::value,
+                  "NodePolicyT should be a node policy, see StaticSearchConcept::IsNodePolicy.");
+    static_assert(StaticSearchConcept::IsQueue<QueueT, typename NodePolicyT::NodeT>::value,
+                  "QueueT should be a queue of nodes, see StaticSearchConcept::IsQueue.");
+
+public:
+    typedef typename ProblemT::StateT                                 StateT;
+    typedef typename ProblemT::ExpandCostT                            ExpandCostT;
+    typedef typename NodePolicyT::NodeT                               NodeT;
+    typedef StaticExpandResult<StateT, NodeT, ExpandCostT, ProblemT::MaxSuccessors> ExpandResultT;
+    typedef SearchResult<NodeT>                                       SearchResultT;
+
+protected:
+    NodePolicyT nodePolicy;
+
+    explicit StaticSearcher(NodePolicyT nodePolicy = NodePolicyT()) : nodePolicy(nodePolicy) {}
+
+private:
+    ExpandResultT expand(const ProblemT& problem, const NodeT& node) const
+    {
+        ExpandResultT result(node);
+        problem.forEachSuccessor(nodePolicy.toState(node), [&](const StateT& state, ExpandCostT cost) {
+            result.add(state, cost);
+        });
+        return result;
+    }
+
+public:
+    //! <tt>function general-search(problem, QUEUEING-FUNCTION)</tt>
+    SearchResultT generalSearch(const ProblemT& problem, QueueT& nodes)
+    {
+        // nodes = MAKE-QUEUE(MAKE-NODE(problem, INITIAL-STATE)
+        nodes.push(nodePolicy.makeNode(problem.getInitialState()));
+
+        while (true)
+        {
+            // if EMPTY(nodes) then return "failure"
+            if (nodes.isEmpty())
+                return SearchResultT::Failure();
+
+            // node = REMOVE-FRONT(nodes)
+            NodeT node = nodes.top();
+            nodes.pop();
+
+            // if problem.GOAL-TEST(node.STATE) succeeds then return node
+            if (problem.goalTest(nodePolicy.toState(node)))
+                return SearchResultT::Success(node);
+
+            // nodes = QUEUING-FUNCTION(nodes, EXPAND(node, problem.OPERATORS))
+            static_cast<DerivedT*>(this)->queue(nodes, expand(problem, node));
+        }
+    }
+};
+
+#endif
@@ -2,23 +2,51 @@
 #include <array>
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <vector>
+#include <memory>
 #include <functional>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
+#include <deque>
 #include <chrono>
+#include <limits>
 #include <sstream>
+#include <fstream>
+#include <string>
+#include <thread>
 using namespace std;
 
+#include "Arena.hpp"
 #include "PriorityQueue.hpp"
+#include "HashTable.hpp"
 #include "GeneralSearch.hpp"
+#include "StaticSearch.hpp"
 
 #include "NPuzzleSetting.hpp"
 #include "NPuzzleDefinition.hpp"
 #include "NPuzzleUtility.hpp"
+#include "NPuzzleGoal.hpp"
 #include "NPuzzleProblem.hpp"
 #include "NPuzzleHeuristicFunction.hpp"
+#include "NPuzzleHeuristicKernel.hpp"
+#include "NPuzzleOperatorSelection.hpp"
+#include "NPuzzleCheckpoint.hpp"
+#include "NPuzzleHeuristicTable.hpp"
+#include "NPuzzlePerimeter.hpp"
 #include "NPuzzleSolver.hpp"
+#include "NPuzzleAnytimeSolver.hpp"
+#include "NPuzzleFringeSolver.hpp"
+#include "NPuzzleRealTimeSolver.hpp"
+#include "NPuzzleBoard.hpp"
+#include "NPuzzleMacroSolver.hpp"
+#include "NPuzzleLazyHeuristic.hpp"
+#include "NPuzzleLazySolver.hpp"
+#include "NPuzzleFrontierSolver.hpp"
+#include "NPuzzleBatchFile.hpp"
+#include "NPuzzleGenerator.hpp"
+#include "NPuzzleStaticSolver.hpp"
 using namespace NPuzzle;
 
 int main(int argc, char* argv[])
@@ -49,16 +77,6 @@ int main(int argc, char* argv[])
     }
     cout << endl;
 
-    if (!isSolvable(initialState))
-    {
-        cout << "The initial configuration is unsolvable under the default goal state." << endl;
-        cout << "Type \"1\" to exit the solver, or \"2\" to continue anyway." << endl;
-        cin >> selection;
-
-        if (selection == 1) return 0;
-        else cout << endl;
-    }
-
     cout << "Type \"1\" to use a default goal state, or \"2\" to enter your own goal state." << endl;
     cin >> selection;
     if (selection == 2)
@@ -78,10 +96,18 @@ int main(int argc, char* argv[])
     }
     cout << endl;
 
+    // The solver would reject it anyway, but there is no need to choose an algorithm.
+    if (!isSolvable(initialState, finalState))
+    {
+        cout << "The initial configuration is unsolvable under the goal state." << endl;
+        return 0;
+    }
+
     cout << "Enter your choice of algorithm:" << endl;
     cout << "  1. Uniform Cost Search." << endl;
     cout << "  2. A* with the Misplaced Tile heuristic." << endl;
     cout << "  3. A* with the Manhattan distance heuristic." << endl;
+    cout << "  4. A* with the Manhattan distance and linear conflicts heuristic." << endl;
     cin >> selection;
     cout << endl;
 
@@ -96,6 +122,10 @@ int main(int argc, char* argv[])
         solver.setHeuristicFunction(GetMisplacedTileCount);
         break;
 
+    case 4: // A* with Manhattan distance and linear conflicts
+        solver.setHeuristicFunction(GetLinearConflictDistance);
+        break;
+
     case 3: // A* with Manhattan distance
     default:
         solver.setHeuristicFunction(GetManhattanDistance);
@@ -107,13 +137,14 @@ int main(int argc, char* argv[])
     cout << endl;
 
     auto result = solver.solve(initialState, finalState);
-    if (!result.isSucceeded())
+    if (result.isRejected())
+        cout << "No solution! The initial configuration is unsolvable." << endl;
+    else if (!result.isSucceeded())
         cout << "No solution!" << endl;
     else
     {
         auto path = solver.getSolutionPath();
         auto gFunc = NPuzzleSolver::GFunc;
-        auto hFunc = solver.getHeuristicFunction();
 
         for (auto& node : path)
         {
@@ -121,7 +152,7 @@ int main(int argc, char* argv[])
             if (node.getState() != initialState)
             {
                 cout << "The best state to expand with a g(n) = " << gFunc(node);
-                cout << " and h(n) = " << hFunc(node) << " is..." << endl;
+                cout << " and h(n) = " << solver.getHeuristicCost(node) << " is..." << endl;
                 printState(node.getState());
                 cout << "Expanding this node..." << endl;
                 cout << endl;
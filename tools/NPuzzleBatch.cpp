@@ -0,0 +1,273 @@
+#include <iostream>
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <deque>
+#include <chrono>
+#include <limits>
+#include <sstream>
+#include <fstream>
+#include <string>
+#include <thread>
+using namespace std;
+
+#include "Arena.hpp"
+#include "PriorityQueue.hpp"
+#include "HashTable.hpp"
+#include "GeneralSearch.hpp"
+#include "StaticSearch.hpp"
+
+#include "NPuzzleSetting.hpp"
+#include "NPuzzleDefinition.hpp"
+#include "NPuzzleUtility.hpp"
+#include "NPuzzleGoal.hpp"
+#include "NPuzzleProblem.hpp"
+#include "NPuzzleHeuristicFunction.hpp"
+#include "NPuzzleHeuristicKernel.hpp"
+#include "NPuzzleOperatorSelection.hpp"
+#include "NPuzzleCheckpoint.hpp"
+#include "NPuzzleHeuristicTable.hpp"
+#include "NPuzzlePerimeter.hpp"
+#include "NPuzzleSolver.hpp"
+#include "NPuzzleAnytimeSolver.hpp"
+#include "NPuzzleFringeSolver.hpp"
+#include "NPuzzleRealTimeSolver.hpp"
+#include "NPuzzleBoard.hpp"
+#include "NPuzzleMacroSolver.hpp"
+#include "NPuzzleLazyHeuristic.hpp"
+#include "NPuzzleLazySolver.hpp"
+#include "NPuzzleFrontierSolver.hpp"
+#include "NPuzzleBatchFile.hpp"
+#include "NPuzzleGenerator.hpp"
+#include "NPuzzleStaticSolver.hpp"
+using namespace NPuzzle;
+
+// Parse a non-negative number, false if the whole text is not one.
+bool parseNumber(const string& text, uint64_t& value)
+{
+    try
+    {
+        size_t used = 0;
+        value = stoull(text, &used);
+        return used == text.size() && text[0] != '-';
+    }
+    catch (const logic_error&)
+    {
+        return false;
+    }
+}
+
+// The radius of the perimeter around the default goal, shared by all workers.
+const int PerimeterRadius = demonstration == 8 ? 16 : 12;
+// The number of instances solved by all workers before their results are written in order.
+const size_t SolveChunkSize = 4096;
+
+// Solve an instance, and make its result record and moves.
+BatchFile::ResultRecord solveOne(NPuzzleSolver& solver, const BatchFile::InstanceRecord& instance,
+                                 const NPuzzleState& finalState, vector<NPuzzleMove>& moves)
+{
+    auto start = chrono::steady_clock::now();
+    auto result = solver.solve(instance.toState(), finalState);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    moves.clear();
+    auto record = BatchFile::ResultRecord();
+    record.id = instance.id;
+    record.nodesExpanded = solver.getTotalNodesExpanded();
+    record.seconds = seconds;
+    if (result.isRejected())
+        record.status = BatchFile::ResultStatus::Rejected;
+    else if (!result.isSucceeded())
+        record.status = BatchFile::ResultStatus::Failed;
+    else
+    {
+        record.status = BatchFile::ResultStatus::Solved;
+        auto path = solver.getSolutionPath();
+        for (size_t i = 0; i < path.size(); i++)
+        {
+            auto next = i + 1 < path.size() ? path[i + 1].getState() : finalState;
+            moves.push_back(BatchFile::GetMoveBetween(path[i].getState(), next));
+        }
+    }
+    record.length = static_cast<uint32_t>(moves.size());
+    return record;
+}
+
+// Solve every instance in an instance file, appending the results to a result file.
+// Each worker has its own solver, all of them share one perimeter around the default goal.
+int solveAll(const string& instancePath, const string& resultPath, unsigned threads)
+{
+    NPuzzleInstanceReader instances(instancePath);
+    if (!instances.getError().empty())
+    {
+        cerr << instances.getError() << endl;
+        return 1;
+    }
+
+    NPuzzleResultWriter results(resultPath);
+    auto finalState = NPuzzleGoal::DefaultGoal();
+    auto perimeter = make_shared<const NPuzzlePerimeter>(finalState, PerimeterRadius);
+
+    unsigned workers = threads ? threads : max(1u, thread::hardware_concurrency());
+    vector<unique_ptr<NPuzzleSolver>> solvers;
+    for (unsigned worker = 0; worker < workers; worker++)
+    {
+        solvers.emplace_back(new NPuzzleSolver());
+        solvers.back()->setHeuristicFunction(GetManhattanDistance);
+        // Batch expansion is the optimal one of the modes of NPuzzleSolver.
+        solvers.back()->setBatchSize(16);
+        solvers.back()->setPerimeter(perimeter);
+    }
+
+    vector<BatchFile::ResultRecord> records(SolveChunkSize);
+    vector<vector<NPuzzleMove>> moves(SolveChunkSize);
+    for (size_t first = 0; first < instances.size(); first += SolveChunkSize)
+    {
+        size_t size = min(SolveChunkSize, instances.size() - first);
+        vector<thread> pool;
+        for (unsigned worker = 0; worker < workers; worker++)
+        {
+            pool.emplace_back([&, worker] {
+                for (size_t i = worker; i < size; i += workers)
+                    records[i] = solveOne(*solvers[worker], instances[first + i], finalState, moves[i]);
+            });
+        }
+        for (auto& worker : pool)
+            worker.join();
+
+        for (size_t i = 0; i < size; i++)
+            results.write(records[i], moves[i]);
+    }
+
+    if (!results.isGood())
+    {
+        cerr << "Cannot write " << resultPath << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// The max number of candidates solved per instance wanted of each depth, since deep instances are rare.
+const uint64_t CandidatesPerInstance = 100000;
+
+// Generate instances into an instance file, or into one file per optimal depth.
+// All arguments but the path are numbers.
+int generate(const string& kind, const vector<uint64_t>& number, const string& path)
+{
+    if (kind == "depth")
+    {
+        // <per depth> <min depth> <max depth> <seed> <file prefix>
+        NPuzzleGenerator generator(number[3]);
+        vector<unique_ptr<NPuzzleInstanceWriter>> writers;
+        int minDepth = static_cast<int>(number[1]), maxDepth = static_cast<int>(number[2]);
+        for (int depth = minDepth; depth <= maxDepth; depth++)
+            writers.emplace_back(new NPuzzleInstanceWriter(path + "-" + to_string(depth) + ".bin"));
+
+        vector<uint64_t> ids(writers.size(), 0);
+        auto counts = generator.generateByDepth(number[0], minDepth, maxDepth, number[0] * CandidatesPerInstance,
+            [&](int depth, const NPuzzleState& state) {
+                writers[depth - minDepth]->write(ids[depth - minDepth]++, state);
+            });
+        for (int depth = minDepth; depth <= maxDepth; depth++)
+            cerr << "Depth " << depth << ": " << counts[depth - minDepth] << " instances." << endl;
+        return 0;
+    }
+
+    NPuzzleGenerator generator(number[kind == "walk" ? 2 : 1]);
+    NPuzzleInstanceWriter out(path);
+    auto sink = [&](uint64_t index, const NPuzzleState& state) { out.write(index, state); };
+    if (kind == "walk")
+        generator.generateWalk(number[0], static_cast<int>(number[1]), sink);
+    else
+        generator.generateUniform(number[0], sink);
+
+    if (!out.isGood())
+    {
+        cerr << "Cannot write " << path << endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    string command = argc > 1 ? argv[1] : "";
+    if (command == "to-binary" && argc == 4)
+    {
+        ifstream in(argv[2]);
+        NPuzzleInstanceWriter out(argv[3]);
+        auto count = BatchFile::ConvertInstancesFromText(in, out);
+        if (!in.eof() || count < 0 || !out.isGood())
+        {
+            cerr << "Cannot convert " << argv[2] << endl;
+            return 1;
+        }
+        cerr << count << " instances converted." << endl;
+        return 0;
+    }
+    if (command == "to-text" && argc == 3)
+    {
+        NPuzzleInstanceReader in(argv[2]);
+        if (!in.getError().empty())
+        {
+            cerr << in.getError() << endl;
+            return 1;
+        }
+        BatchFile::ConvertInstancesToText(in, cout);
+        return 0;
+    }
+    if (command == "results-to-text" && argc == 3)
+    {
+        NPuzzleResultReader in(argv[2]);
+        BatchFile::ConvertResultsToText(in, cout);
+        if (!in.getError().empty())
+        {
+            cerr << in.getError() << endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (command == "results-to-binary" && argc == 4)
+    {
+        ifstream in(argv[2]);
+        NPuzzleResultWriter out(argv[3]);
+        auto count = BatchFile::ConvertResultsFromText(in, out);
+        if (!in.eof() || count < 0 || !out.isGood())
+        {
+            cerr << "Cannot convert " << argv[2] << endl;
+            return 1;
+        }
+        cerr << count << " results converted." << endl;
+        return 0;
+    }
+    uint64_t threads = 0;
+    if (command == "solve" && (argc == 4 || (argc == 5 && parseNumber(argv[4], threads))))
+        return solveAll(argv[2], argv[3], static_cast<unsigned>(threads));
+    if ((command == "uniform" && argc == 5) || (command == "walk" && argc == 6) || (command == "depth" && argc == 7))
+    {
+        vector<uint64_t> numbers(argc - 3);
+        bool parsed = true;
+        for (int i = 2; i < argc - 1 && parsed; i++)
+            parsed = parseNumber(argv[i], numbers[i - 2]);
+        if (parsed)
+            return generate(command, numbers, argv[argc - 1]);
+    }
+
+    cerr << "Usage:" << endl;
+    cerr << "  " << argv[0] << " to-binary <text instances> <instance file>" << endl;
+    cerr << "  " << argv[0] << " to-text <instance file>" << endl;
+    cerr << "  " << argv[0] << " solve <instance file> <result file> [threads]" << endl;
+    cerr << "  " << argv[0] << " results-to-text <result file>" << endl;
+    cerr << "  " << argv[0] << " results-to-binary <text results> <result file>" << endl;
+    cerr << "  " << argv[0] << " uniform <count> <seed> <instance file>" << endl;
+    cerr << "  " << argv[0] << " walk <count> <moves> <seed> <instance file>" << endl;
+    cerr << "  " << argv[0] << " depth <count per depth> <min depth> <max depth> <seed> <file prefix>" << endl;
+    return 1;
+}